@@ -2746,8 +2746,8 @@ void activity_handlers::travel_do_turn( player_activity *act, player *p )
                 }
             }
         }
-        const auto route_to = g->m.route( p->pos(), centre_sub, p->get_pathfinding_settings(),
-                                          p->get_path_avoid() );
+        const auto route_to = g->m.route_hierarchical( p->pos(), centre_sub,
+                              p->get_pathfinding_settings(), p->get_path_avoid() );
         if( !route_to.empty() ) {
             const activity_id act_travel = activity_id( "ACT_TRAVELLING" );
             p->set_destination( route_to, player_activity( act_travel ) );
@@ -3957,7 +3957,8 @@ static void perform_zone_activity_turn( player *p,
     for( auto &tile : tiles ) {
         const auto &tile_loc = g->m.getlocal( tile );
 
-        auto route = g->m.route( p->pos(), tile_loc, p->get_pathfinding_settings(), p->get_path_avoid() );
+        auto route = g->m.route_hierarchical( p->pos(), tile_loc, p->get_pathfinding_settings(),
+                                              p->get_path_avoid() );
         if( route.size() > 1 ) {
             route.pop_back();
 
@@ -0,0 +1,192 @@
+#include "background_writer.h"
+
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "cata_utility.h"
+#include "filesystem.h"
+#include "string_formatter.h"
+
+void patch_file( const std::string &path, const file_patch &patch )
+{
+    std::fstream fout( path, std::ios::binary | std::ios::in | std::ios::out );
+    if( !fout.is_open() ) {
+        throw std::runtime_error( "opening file failed" );
+    }
+    for( const auto &chunk : patch ) {
+        fout.seekp( chunk.first );
+        fout.write( chunk.second.data(), chunk.second.size() );
+        fout.flush();
+        if( !fout ) {
+            throw std::runtime_error( "writing to file failed" );
+        }
+    }
+}
+
+background_writer::~background_writer()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    wake_worker.notify_all();
+    if( thread.joinable() ) {
+        thread.join();
+    }
+}
+
+void background_writer::write( const std::string &path, std::string data,
+                               std::vector<std::string> obsolete )
+{
+    queue( job{ path, job_type::write, std::move( data ), file_patch(), std::move( obsolete ) } );
+}
+
+void background_writer::update( const std::string &path, file_patch patch,
+                                std::vector<std::string> obsolete )
+{
+    queue( job{ path, job_type::update, std::string(), std::move( patch ), std::move( obsolete ) } );
+}
+
+void background_writer::remove( const std::string &path )
+{
+    queue( job{ path, job_type::remove, std::string(), file_patch(), {} } );
+}
+
+void background_writer::queue( job &&j )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    const auto iter = queued_paths.find( j.path );
+    if( iter != queued_paths.end() && j.type != job_type::update ) {
+        // Not started yet, so nobody can tell the older content was never written.
+        std::vector<std::string> &obsolete = iter->second->obsolete;
+        obsolete.insert( obsolete.end(), j.obsolete.begin(), j.obsolete.end() );
+        j.obsolete = std::move( obsolete );
+        *iter->second = std::move( j );
+    } else {
+        const std::string path = j.path;
+        queued_paths[path] = jobs.insert( jobs.end(), std::move( j ) );
+    }
+    if( !thread.joinable() ) {
+        thread = std::thread( &background_writer::work, this );
+    }
+    wake_worker.notify_all();
+}
+
+void background_writer::work()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    while( true ) {
+        wake_worker.wait( lock, [this] {
+            return stopping || !jobs.empty();
+        } );
+        if( jobs.empty() ) {
+            // Only get here when stopping, queued jobs are always finished first.
+            return;
+        }
+        // Only the last job queued for a path is in there.
+        const auto iter = queued_paths.find( jobs.front().path );
+        if( iter != queued_paths.end() && iter->second == jobs.begin() ) {
+            queued_paths.erase( iter );
+        }
+        job current = std::move( jobs.front() );
+        jobs.pop_front();
+        running_path = current.path;
+        lock.unlock();
+
+        std::string error;
+        try {
+            switch( current.type ) {
+                case job_type::write:
+                    write_to_file( current.path, [&current]( std::ostream & fout ) {
+                        fout.write( current.data.data(), current.data.size() );
+                    } );
+                    break;
+                case job_type::update:
+                    patch_file( current.path, current.patch );
+                    break;
+                case job_type::remove:
+                    if( file_exist( current.path ) && !remove_file( current.path ) ) {
+                        error = "removing \"" + current.path + "\" failed";
+                    }
+                    break;
+            }
+        } catch( const std::exception &err ) {
+            error = "writing \"" + current.path + "\" failed: " + err.what();
+        }
+        // The obsolete files may still hold the only copy of their content.
+        const bool failed = !error.empty();
+        if( !failed ) {
+            for( const std::string &path : current.obsolete ) {
+                if( file_exist( path ) && !remove_file( path ) ) {
+                    error = "removing \"" + path + "\" failed";
+                }
+            }
+        }
+
+        lock.lock();
+        running_path.clear();
+        if( !error.empty() ) {
+            errors.push_back( error );
+        }
+        if( failed && current.type != job_type::remove ) {
+            failed_paths.insert( current.path );
+        }
+        job_done.notify_all();
+    }
+}
+
+void background_writer::wait_for( const std::string &path )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    job_done.wait( lock, [this, &path] {
+        return running_path != path && queued_paths.count( path ) == 0;
+    } );
+}
+
+void background_writer::flush()
+{
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        job_done.wait( lock, [this] {
+            return jobs.empty() && running_path.empty();
+        } );
+    }
+    rethrow_errors();
+}
+
+void background_writer::rethrow_errors()
+{
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if( errors.empty() ) {
+            return;
+        }
+        error = errors.front();
+        if( errors.size() > 1 ) {
+            error += string_format( " (and %d more errors)", errors.size() - 1 );
+        }
+        errors.clear();
+    }
+    throw std::runtime_error( error );
+}
+
+bool background_writer::take_failure( const std::string &path )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return failed_paths.erase( path ) != 0;
+}
+
+size_t background_writer::pending() const
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return jobs.size() + ( running_path.empty() ? 0 : 1 );
+}
+
+background_writer &get_save_writer()
+{
+    static background_writer writer;
+    return writer;
+}
@@ -0,0 +1,124 @@
+#pragma once
+#ifndef BACKGROUND_WRITER_H
+#define BACKGROUND_WRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+/** Chunks of a file to overwrite, as offset and new data, in the order they are written. */
+using file_patch = std::vector<std::pair<uint64_t, std::string>>;
+
+/**
+ * Overwrites the chunks of the existing file at @p path one by one, each is flushed before
+ * the next is written. Unlike @ref write_to_file this changes the file in place.
+ * @throw std::runtime_error if the file does not exist or writing fails.
+ */
+void patch_file( const std::string &path, const file_patch &patch );
+
+/**
+ * Writes already serialized files on a separate thread.
+ *
+ * The content is produced on the calling thread (so it is a consistent snapshot of the
+ * game state) and only the file system access happens in the background. Files are
+ * written via @ref write_to_file, so a failed write keeps the previous file.
+ *
+ * Anything reading a file that may have been queued here must call @ref wait_for first.
+ */
+class background_writer
+{
+    public:
+        background_writer() = default;
+        /** Finishes all queued jobs. */
+        ~background_writer();
+
+        background_writer( const background_writer & ) = delete;
+        background_writer &operator=( const background_writer & ) = delete;
+
+        /**
+         * Queues writing @p data to @p path. An older job for the same path that has not
+         * been started yet is replaced, the files it would have removed are removed by
+         * this one instead.
+         * @param obsolete Files removed once @p path has been written, they are kept if
+         * writing fails.
+         */
+        void write( const std::string &path, std::string data,
+                    std::vector<std::string> obsolete = {} );
+        /**
+         * Queues applying @p patch to @p path (see @ref patch_file). Other jobs for the same
+         * path are kept, as the patch depends on the file content they leave behind.
+         * @param obsolete As for @ref write.
+         */
+        void update( const std::string &path, file_patch patch,
+                     std::vector<std::string> obsolete = {} );
+        /** Queues removing the file at @p path, after all jobs queued before. */
+        void remove( const std::string &path );
+
+        /** Blocks until there is no queued or running job for @p path. */
+        void wait_for( const std::string &path );
+        /**
+         * Blocks until all queued jobs are done.
+         * @throws std::runtime_error if any of the jobs failed, see @ref rethrow_errors.
+         */
+        void flush();
+        /**
+         * Throws std::runtime_error describing the first failed job since the last call.
+         * The error list is cleared in the process.
+         */
+        void rethrow_errors();
+        /**
+         * Whether a write or update of @p path failed since the last call for it, the file
+         * then has the content it had before the failed job. Does not wait for queued jobs.
+         */
+        bool take_failure( const std::string &path );
+
+        /** Number of jobs that are queued or running. */
+        size_t pending() const;
+
+    private:
+        enum class job_type : int {
+            write,
+            update,
+            remove,
+        };
+        struct job {
+            std::string path;
+            job_type type;
+            std::string data;
+            file_patch patch;
+            std::vector<std::string> obsolete;
+        };
+
+        void queue( job &&j );
+        void work();
+
+        std::thread thread;
+        mutable std::mutex mutex;
+        std::condition_variable wake_worker;
+        std::condition_variable job_done;
+        std::list<job> jobs;
+        /** Jobs in @ref jobs by path, only the last one queued for each path. */
+        std::map<std::string, std::list<job>::iterator> queued_paths;
+        /** Path of the job being run, empty if there is none. */
+        std::string running_path;
+        std::vector<std::string> errors;
+        /** Paths of failed write and update jobs, see @ref take_failure. */
+        std::set<std::string> failed_paths;
+        bool stopping = false;
+};
+
+/** The writer used for saving the map and the overmaps. */
+background_writer &get_save_writer();
+
+#endif
@@ -249,12 +249,20 @@ void cata_tiles::load_tileset( const std::string &tileset_id, const bool prechec
     tileset_loader loader( *new_tileset_ptr, renderer );
     loader.load( tileset_id, precheck );
     tileset_ptr = std::move( new_tileset_ptr );
+    clear_resolved_tiles();
 
     set_draw_scale( 16 );
 
     minimap->set_type( tile_iso ? pixel_minimap_type::iso : pixel_minimap_type::ortho );
 }
 
+void cata_tiles::clear_resolved_tiles()
+{
+    for( resolved_tile_tables &tables : resolved_tiles ) {
+        tables = resolved_tile_tables();
+    }
+}
+
 void cata_tiles::reinit()
 {
     set_draw_scale( 16 );
@@ -1029,6 +1037,8 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
     int sy = 0;
     get_window_tile_counts( width, height, sx, sy );
 
+    resolved_season = season_of_year( calendar::turn );
+
     init_light();
     g->m.update_visibility_cache( center.z );
     const visibility_variables &cache = g->m.get_visibility_variables_cache();
@@ -1419,15 +1429,15 @@ void cata_tiles::get_window_tile_counts( const int width, const int height, int
     }
 }
 
-bool cata_tiles::draw_from_id_string( std::string id, const tripoint &pos, int subtile, int rota,
-                                      lit_level ll, bool apply_night_vision_goggles )
+bool cata_tiles::draw_from_id_string( const std::string &id, const tripoint &pos, int subtile,
+                                      int rota, lit_level ll, bool apply_night_vision_goggles )
 {
     int nullint = 0;
-    return cata_tiles::draw_from_id_string( std::move( id ), C_NONE, empty_string, pos, subtile, rota,
+    return cata_tiles::draw_from_id_string( id, C_NONE, empty_string, pos, subtile, rota,
                                             ll, apply_night_vision_goggles, nullint );
 }
 
-bool cata_tiles::draw_from_id_string( std::string id, TILE_CATEGORY category,
+bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY category,
                                       const std::string &subcategory, const tripoint &pos,
                                       int subtile, int rota, lit_level ll,
                                       bool apply_night_vision_goggles )
@@ -1437,10 +1447,10 @@ bool cata_tiles::draw_from_id_string( std::string id, TILE_CATEGORY category,
                                             ll, apply_night_vision_goggles, nullint );
 }
 
-bool cata_tiles::draw_from_id_string( std::string id, const tripoint &pos, int subtile, int rota,
-                                      lit_level ll, bool apply_night_vision_goggles, int &height_3d )
+bool cata_tiles::draw_from_id_string( const std::string &id, const tripoint &pos, int subtile,
+                                      int rota, lit_level ll, bool apply_night_vision_goggles, int &height_3d )
 {
-    return cata_tiles::draw_from_id_string( std::move( id ), C_NONE, empty_string, pos, subtile, rota,
+    return cata_tiles::draw_from_id_string( id, C_NONE, empty_string, pos, subtile, rota,
                                             ll, apply_night_vision_goggles, height_3d );
 }
 
@@ -1451,7 +1461,7 @@ const tile_type *cata_tiles::find_tile_with_season( std::string &id )
         "_season_spring", "_season_summer", "_season_autumn", "_season_winter"
     };
 
-    std::string seasonal_id = id + season_suffix[season_of_year( calendar::turn )];
+    std::string seasonal_id = id + season_suffix[resolved_season];
 
     const tile_type *tt = tileset_ptr->find_tile_type( seasonal_id );
     if( tt ) {
@@ -1462,7 +1472,73 @@ const tile_type *cata_tiles::find_tile_with_season( std::string &id )
     return tt;
 }
 
-const tile_type *cata_tiles::find_tile_looks_like( std::string &id, TILE_CATEGORY category )
+const cata_tiles::resolved_tile &cata_tiles::find_tile_looks_like( const std::string &id,
+        TILE_CATEGORY category )
+{
+    std::unordered_map<std::string, resolved_tile> &resolved =
+        resolved_tiles[resolved_season].by_id[category];
+    const auto iter = resolved.find( id );
+    if( iter != resolved.end() ) {
+        return iter->second;
+    }
+    return resolved.emplace( id, resolve_tile( id, category ) ).first->second;
+}
+
+cata_tiles::resolved_tile cata_tiles::resolve_tile( const std::string &id, TILE_CATEGORY category )
+{
+    resolved_tile result;
+    result.id = id;
+    result.tt = resolve_tile_looks_like( result.id, category );
+    if( result.tt && result.tt->multitile ) {
+        const std::vector<std::string> &available = result.tt->available_subtiles;
+        for( size_t i = 0; i < multitile_keys.size(); i++ ) {
+            if( std::find( available.begin(), available.end(), multitile_keys[i] ) != available.end() ) {
+                std::string subtile_id = result.id + "_" + multitile_keys[i];
+                result.subtiles[i] = resolve_tile_looks_like( subtile_id, category );
+            }
+        }
+    }
+    return result;
+}
+
+const cata_tiles::resolved_tile &cata_tiles::find_terrain_tile( const ter_id &ter )
+{
+    std::vector<resolved_tile> &tiles = resolved_tiles[resolved_season].terrain;
+    if( tiles.empty() ) {
+        tiles.reserve( ter_t::count() );
+        for( size_t i = 0; i < ter_t::count(); i++ ) {
+            tiles.push_back( resolve_tile( ter_id( i ).id().str(), C_TERRAIN ) );
+        }
+    }
+    return tiles[ter.to_i()];
+}
+
+const cata_tiles::resolved_tile &cata_tiles::find_furniture_tile( const furn_id &furn )
+{
+    std::vector<resolved_tile> &tiles = resolved_tiles[resolved_season].furniture;
+    if( tiles.empty() ) {
+        tiles.reserve( furn_t::count() );
+        for( size_t i = 0; i < furn_t::count(); i++ ) {
+            tiles.push_back( resolve_tile( furn_id( i ).id().str(), C_FURNITURE ) );
+        }
+    }
+    return tiles[furn.to_i()];
+}
+
+const cata_tiles::resolved_tile &cata_tiles::find_monster_tile( const mtype &type )
+{
+    std::vector<resolved_tile> &tiles = resolved_tiles[resolved_season].monsters;
+    if( tiles.empty() ) {
+        const std::vector<mtype> &all = MonsterGenerator::generator().get_all_mtypes();
+        tiles.reserve( all.size() );
+        for( const mtype &mt : all ) {
+            tiles.push_back( resolve_tile( mt.id.str(), C_MONSTER ) );
+        }
+    }
+    return tiles[type.id.id().to_i()];
+}
+
+const tile_type *cata_tiles::resolve_tile_looks_like( std::string &id, TILE_CATEGORY category )
 {
     std::string looks_like = id;
     for( int cnt = 0; cnt < 10 && !looks_like.empty(); cnt++ ) {
@@ -1559,7 +1635,7 @@ bool cata_tiles::find_overlay_looks_like( const bool male, const std::string &ov
     return exists;
 }
 
-bool cata_tiles::draw_from_id_string( std::string id, TILE_CATEGORY category,
+bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY category,
                                       const std::string &subcategory, const tripoint &pos,
                                       int subtile, int rota, lit_level ll,
                                       bool apply_night_vision_goggles, int &height_3d )
@@ -1577,153 +1653,151 @@ bool cata_tiles::draw_from_id_string( std::string id, TILE_CATEGORY category,
         return false;
     }
 
-    const tile_type *tt = find_tile_looks_like( id, category );
+    const resolved_tile &resolved = find_tile_looks_like( id, category );
+    if( resolved.tt ) {
+        return draw_resolved_tile( resolved, category, subcategory, pos, subtile, rota, ll,
+                                   apply_night_vision_goggles, height_3d );
+    }
 
-    if( !tt ) {
-        uint32_t sym = UNKNOWN_UNICODE;
-        nc_color col = c_white;
-        if( category == C_FURNITURE ) {
-            const furn_str_id fid( id );
-            if( fid.is_valid() ) {
-                const furn_t &f = fid.obj();
-                sym = f.symbol();
-                col = f.color();
-            }
-        } else if( category == C_TERRAIN ) {
-            const ter_str_id tid( id );
-            if( tid.is_valid() ) {
-                const ter_t &t = tid.obj();
-                sym = t.symbol();
-                col = t.color();
-            }
-        } else if( category == C_MONSTER ) {
-            const mtype_id mid( id );
-            if( mid.is_valid() ) {
-                const mtype &mt = mid.obj();
-                sym = UTF8_getch( mt.sym );
-                col = mt.color;
+    uint32_t sym = UNKNOWN_UNICODE;
+    nc_color col = c_white;
+    if( category == C_FURNITURE ) {
+        const furn_str_id fid( id );
+        if( fid.is_valid() ) {
+            const furn_t &f = fid.obj();
+            sym = f.symbol();
+            col = f.color();
+        }
+    } else if( category == C_TERRAIN ) {
+        const ter_str_id tid( id );
+        if( tid.is_valid() ) {
+            const ter_t &t = tid.obj();
+            sym = t.symbol();
+            col = t.color();
+        }
+    } else if( category == C_MONSTER ) {
+        const mtype_id mid( id );
+        if( mid.is_valid() ) {
+            const mtype &mt = mid.obj();
+            sym = UTF8_getch( mt.sym );
+            col = mt.color;
+        }
+    } else if( category == C_VEHICLE_PART ) {
+        const vpart_id vpid( id.substr( 3 ) );
+        if( vpid.is_valid() ) {
+            const vpart_info &v = vpid.obj();
+
+            if( subtile == open_ ) {
+                sym = '\'';
+            } else if( subtile == broken ) {
+                sym = v.sym_broken;
+            } else {
+                sym = v.sym;
             }
-        } else if( category == C_VEHICLE_PART ) {
-            const vpart_id vpid( id.substr( 3 ) );
-            if( vpid.is_valid() ) {
-                const vpart_info &v = vpid.obj();
-
-                if( subtile == open_ ) {
-                    sym = '\'';
-                } else if( subtile == broken ) {
-                    sym = v.sym_broken;
-                } else {
-                    sym = v.sym;
-                }
-                subtile = -1;
+            subtile = -1;
 
-                tileray face = tileray( rota );
-                sym = special_symbol( face.dir_symbol( sym ) );
-                rota = 0;
+            tileray face = tileray( rota );
+            sym = special_symbol( face.dir_symbol( sym ) );
+            rota = 0;
+
+            col = v.color;
+        }
+    } else if( category == C_FIELD ) {
+        const field_type_id fid = field_type_id( id );
+        sym = fid.obj().get_codepoint();
+        // TODO: field intensity?
+        col = fid.obj().get_color();
+    } else if( category == C_TRAP ) {
+        const trap_str_id tmp( id );
+        if( tmp.is_valid() ) {
+            const trap &t = tmp.obj();
+            sym = t.sym;
+            col = t.color;
+        }
+    } else if( category == C_ITEM ) {
+        item tmp;
+        if( 0 == id.compare( 0, 7, "corpse_" ) ) {
+            tmp = item( "corpse", 0 );
+        } else {
+            tmp = item( id, 0 );
+        }
+        sym = tmp.symbol().empty() ? ' ' : tmp.symbol().front();
+        col = tmp.color();
+    }
+    // Special cases for walls
+    switch( sym ) {
+        case LINE_XOXO:
+            sym = LINE_XOXO_C;
+            break;
+        case LINE_OXOX:
+            sym = LINE_OXOX_C;
+            break;
+        case LINE_XXOO:
+            sym = LINE_XXOO_C;
+            break;
+        case LINE_OXXO:
+            sym = LINE_OXXO_C;
+            break;
+        case LINE_OOXX:
+            sym = LINE_OOXX_C;
+            break;
+        case LINE_XOOX:
+            sym = LINE_XOOX_C;
+            break;
+        case LINE_XXXO:
+            sym = LINE_XXXO_C;
+            break;
+        case LINE_XXOX:
+            sym = LINE_XXOX_C;
+            break;
+        case LINE_XOXX:
+            sym = LINE_XOXX_C;
+            break;
+        case LINE_OXXX:
+            sym = LINE_OXXX_C;
+            break;
+        case LINE_XXXX:
+            sym = LINE_XXXX_C;
+            break;
+        default:
+            break; // sym goes unchanged
+    }
+    if( sym != 0 && sym < 256 ) {
+        // see cursesport.cpp, function wattron
+        const int pairNumber = col.to_color_pair_index();
+        const cata_cursesport::pairs &colorpair = cata_cursesport::colorpairs[pairNumber];
+        // What about isBlink?
+        const bool isBold = col.is_bold();
+        const int FG = colorpair.FG + ( isBold ? 8 : 0 );
+        std::string generic_id = get_ascii_tile_id( sym, FG, -1 );
 
-                col = v.color;
-            }
-        } else if( category == C_FIELD ) {
-            const field_type_id fid = field_type_id( id );
-            sym = fid.obj().get_codepoint();
-            // TODO: field intensity?
-            col = fid.obj().get_color();
-        } else if( category == C_TRAP ) {
-            const trap_str_id tmp( id );
-            if( tmp.is_valid() ) {
-                const trap &t = tmp.obj();
-                sym = t.sym;
-                col = t.color;
-            }
-        } else if( category == C_ITEM ) {
-            item tmp;
-            if( 0 == id.compare( 0, 7, "corpse_" ) ) {
-                tmp = item( "corpse", 0 );
-            } else {
-                tmp = item( id, 0 );
-            }
-            sym = tmp.symbol().empty() ? ' ' : tmp.symbol().front();
-            col = tmp.color();
+        // do not rotate fallback tiles!
+        if( sym != LINE_XOXO_C && sym != LINE_OXOX_C ) {
+            rota = 0;
         }
-        // Special cases for walls
-        switch( sym ) {
-            case LINE_XOXO:
-                sym = LINE_XOXO_C;
-                break;
-            case LINE_OXOX:
-                sym = LINE_OXOX_C;
-                break;
-            case LINE_XXOO:
-                sym = LINE_XXOO_C;
-                break;
-            case LINE_OXXO:
-                sym = LINE_OXXO_C;
-                break;
-            case LINE_OOXX:
-                sym = LINE_OOXX_C;
-                break;
-            case LINE_XOOX:
-                sym = LINE_XOOX_C;
-                break;
-            case LINE_XXXO:
-                sym = LINE_XXXO_C;
-                break;
-            case LINE_XXOX:
-                sym = LINE_XXOX_C;
-                break;
-            case LINE_XOXX:
-                sym = LINE_XOXX_C;
-                break;
-            case LINE_OXXX:
-                sym = LINE_OXXX_C;
-                break;
-            case LINE_XXXX:
-                sym = LINE_XXXX_C;
-                break;
-            default:
-                break; // sym goes unchanged
-        }
-        if( sym != 0 && sym < 256 ) {
-            // see cursesport.cpp, function wattron
-            const int pairNumber = col.to_color_pair_index();
-            const cata_cursesport::pairs &colorpair = cata_cursesport::colorpairs[pairNumber];
-            // What about isBlink?
-            const bool isBold = col.is_bold();
-            const int FG = colorpair.FG + ( isBold ? 8 : 0 );
-            std::string generic_id = get_ascii_tile_id( sym, FG, -1 );
-
-            // do not rotate fallback tiles!
-            if( sym != LINE_XOXO_C && sym != LINE_OXOX_C ) {
-                rota = 0;
-            }
 
-            if( tileset_ptr->find_tile_type( generic_id ) ) {
-                return draw_from_id_string( generic_id, pos, subtile, rota,
-                                            ll, apply_night_vision_goggles );
-            }
-            // Try again without color this time (using default color).
-            generic_id = get_ascii_tile_id( sym, -1, -1 );
-            if( tileset_ptr->find_tile_type( generic_id ) ) {
-                return draw_from_id_string( generic_id, pos, subtile, rota,
-                                            ll, apply_night_vision_goggles );
-            }
+        if( tileset_ptr->find_tile_type( generic_id ) ) {
+            return draw_from_id_string( generic_id, pos, subtile, rota,
+                                        ll, apply_night_vision_goggles );
+        }
+        // Try again without color this time (using default color).
+        generic_id = get_ascii_tile_id( sym, -1, -1 );
+        if( tileset_ptr->find_tile_type( generic_id ) ) {
+            return draw_from_id_string( generic_id, pos, subtile, rota,
+                                        ll, apply_night_vision_goggles );
         }
     }
 
     // if id is not found, try to find a tile for the category+subcategory combination
-    if( !tt ) {
-        const std::string &category_id = TILE_CATEGORY_IDS[category];
-        if( !category_id.empty() && !subcategory.empty() ) {
-            tt = tileset_ptr->find_tile_type( "unknown_" + category_id + "_" + subcategory );
-        }
+    const tile_type *tt = nullptr;
+    const std::string &category_id = TILE_CATEGORY_IDS[category];
+    if( !category_id.empty() && !subcategory.empty() ) {
+        tt = tileset_ptr->find_tile_type( "unknown_" + category_id + "_" + subcategory );
     }
 
     // if at this point we have no tile, try just the category
-    if( !tt ) {
-        const std::string &category_id = TILE_CATEGORY_IDS[category];
-        if( !category_id.empty() ) {
-            tt = tileset_ptr->find_tile_type( "unknown_" + category_id );
-        }
+    if( !tt && !category_id.empty() ) {
+        tt = tileset_ptr->find_tile_type( "unknown_" + category_id );
     }
 
     // if we still have no tile, we're out of luck, fall back to unknown
@@ -1736,18 +1810,47 @@ bool cata_tiles::draw_from_id_string( std::string id, TILE_CATEGORY category,
         return false;
     }
 
-    const tile_type &display_tile = *tt;
-    // check to see if the display_tile is multitile, and if so if it has the key related to subtile
-    if( subtile != -1 && display_tile.multitile ) {
-        const auto &display_subtiles = display_tile.available_subtiles;
+    resolved_tile unknown;
+    unknown.tt = tt;
+    unknown.id = id;
+    return draw_resolved_tile( unknown, category, subcategory, pos, subtile, rota, ll,
+                               apply_night_vision_goggles, height_3d );
+}
+
+bool cata_tiles::draw_resolved_tile( const resolved_tile &tile, TILE_CATEGORY category,
+                                     const std::string &subcategory, const tripoint &pos,
+                                     int subtile, int rota, lit_level ll,
+                                     bool apply_night_vision_goggles, int &height_3d )
+{
+    if( !tile.tt ) {
+        // tile.id is the id that was looked up, fall back as for any other id without a tile
+        return draw_from_id_string( tile.id, category, subcategory, pos, subtile, rota, ll,
+                                    apply_night_vision_goggles, height_3d );
+    }
+
+    rectangle screen_bounds( o, o + point( screentile_width, screentile_height ) );
+    if( !tile_iso &&
+        !screen_bounds.contains_half_open( pos.xy() ) ) {
+        return false;
+    }
+
+    const tile_type *tt = tile.tt;
+    // check to see if the tile is multitile, and if so if it has the key related to subtile
+    if( subtile != -1 && tt->multitile ) {
+        const auto &display_subtiles = tt->available_subtiles;
         const auto end = std::end( display_subtiles );
         if( std::find( begin( display_subtiles ), end, multitile_keys[subtile] ) != end ) {
-            // append subtile name to tile and re-find display_tile
-            return draw_from_id_string(
-                       std::move( id.append( "_", 1 ).append( multitile_keys[subtile] ) ),
-                       category, subcategory, pos, -1, rota, ll, apply_night_vision_goggles, height_3d );
+            if( !tile.subtiles[subtile] ) {
+                // the part has no tile, let the fallbacks for its id find one
+                return draw_from_id_string( tile.id + "_" + multitile_keys[subtile], category,
+                                            subcategory, pos, -1, rota, ll, apply_night_vision_goggles,
+                                            height_3d );
+            }
+            tt = tile.subtiles[subtile];
         }
     }
+    const tile_type &display_tile = *tt;
+    const std::string &id = tile.id;
 
     // translate from player-relative to screen relative tile position
     const point screen_pos = player_to_screen( pos.xy() );
@@ -2142,8 +2245,8 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
         }
         // draw the actual terrain if there's no override
         if( !neighborhood_overridden ) {
-            return draw_from_id_string( tname, C_TERRAIN, empty_string, p, subtile, rotation, ll,
-                                        nv_goggles_activated, height_3d );
+            return draw_resolved_tile( find_terrain_tile( t ), C_TERRAIN, empty_string, p, subtile,
+                                       rotation, ll, nv_goggles_activated, height_3d );
         }
     }
     if( invisible[0] ? overridden : neighborhood_overridden ) {
@@ -2160,13 +2263,12 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
             } else {
                 get_terrain_orientation( p, rotation, subtile, terrain_override, invisible );
             }
-            const std::string &tname = t2.id().str();
             // tile overrides are never memorized
             // tile overrides are always shown with full visibility
             const lit_level lit = overridden ? LL_LIT : ll;
             const bool nv = overridden ? false : nv_goggles_activated;
-            return draw_from_id_string( tname, C_TERRAIN, empty_string, p, subtile, rotation, lit, nv,
-                                        height_3d );
+            return draw_resolved_tile( find_terrain_tile( t2 ), C_TERRAIN, empty_string, p, subtile,
+                                       rotation, lit, nv, height_3d );
         }
     } else if( invisible[0] && has_terrain_memory_at( p ) ) {
         // try drawing memory if invisible and not overridden
@@ -2310,8 +2412,8 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
         }
         // draw the actual furniture if there's no override
         if( !neighborhood_overridden ) {
-            return draw_from_id_string( fname, C_FURNITURE, empty_string, p, subtile, rotation, ll,
-                                        nv_goggles_activated, height_3d );
+            return draw_resolved_tile( find_furniture_tile( f ), C_FURNITURE, empty_string, p, subtile,
+                                       rotation, ll, nv_goggles_activated, height_3d );
         }
     }
     if( invisible[0] ? overridden : neighborhood_overridden ) {
@@ -2334,13 +2436,12 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
             int subtile = 0;
             int rotation = 0;
             get_tile_values( f2, neighborhood, subtile, rotation );
-            const std::string &fname = f2.id().str();
             // tile overrides are never memorized
             // tile overrides are always shown with full visibility
             const lit_level lit = overridden ? LL_LIT : ll;
             const bool nv = overridden ? false : nv_goggles_activated;
-            return draw_from_id_string( fname, C_FURNITURE, empty_string, p, subtile, rotation, lit, nv,
-                                        height_3d );
+            return draw_resolved_tile( find_furniture_tile( f2 ), C_FURNITURE, empty_string, p,
+                                       subtile, rotation, lit, nv, height_3d );
         }
     } else if( invisible[0] && has_furniture_memory_at( p ) ) {
         // try drawing memory if invisible and not overridden
@@ -2659,11 +2760,11 @@ bool cata_tiles::draw_critter_at( const tripoint &p, lit_level ll, int &height_3
         is_player = false;
         sees_player = false;
         attitude = std::get<3>( override->second );
-        const std::string &chosen_id = id.str();
-        const std::string &ent_subcategory = id.obj().species.empty() ?
-                                             empty_string : id.obj().species.begin()->str();
-        result = draw_from_id_string( chosen_id, C_MONSTER, ent_subcategory, p, corner, 0, LL_LIT, false,
-                                      height_3d );
+        const mtype &type = id.obj();
+        const std::string &ent_subcategory = type.species.empty() ?
+                                             empty_string : type.species.begin()->str();
+        result = draw_resolved_tile( find_monster_tile( type ), C_MONSTER, ent_subcategory, p, corner,
+                                     0, LL_LIT, false, height_3d );
     } else if( !invisible[0] ) {
         const Creature *pcritter = g->critter_at( p, true );
         if( pcritter == nullptr ) {
@@ -2698,23 +2799,19 @@ bool cata_tiles::draw_critter_at( const tripoint &p, lit_level ll, int &height_3
                 rot_facing = 4;
             }
             if( rot_facing >= 0 ) {
-                const auto ent_name = m->type->id;
-                std::string chosen_id = ent_name.str();
+                const resolved_tile *tile = &find_monster_tile( *m->type );
                 if( m->has_effect( effect_ridden ) ) {
                     int pl_under_height = 6;
                     if( m->mounted_player ) {
                         draw_entity_with_overlays( *m->mounted_player, p, ll, pl_under_height );
                     }
-                    const std::string prefix = "rid_";
-                    std::string copy_id = chosen_id;
-                    const std::string ridden_id = copy_id.insert( 0, prefix );
-                    const tile_type *tt = tileset_ptr->find_tile_type( ridden_id );
-                    if( tt ) {
-                        chosen_id = ridden_id;
+                    const std::string ridden_id = "rid_" + m->type->id.str();
+                    if( tileset_ptr->find_tile_type( ridden_id ) ) {
+                        tile = &find_tile_looks_like( ridden_id, ent_category );
                     }
                 }
-                result = draw_from_id_string( chosen_id, ent_category, ent_subcategory, p, subtile, rot_facing,
-                                              ll, false, height_3d );
+                result = draw_resolved_tile( *tile, ent_category, ent_subcategory, p, subtile, rot_facing,
+                                             ll, false, height_3d );
                 sees_player = m->sees( g->u );
                 attitude = m->attitude_to( g-> u );
             }
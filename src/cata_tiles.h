@@ -2,6 +2,7 @@
 #ifndef CATA_TILES_H
 #define CATA_TILES_H
 
+#include <array>
 #include <cstddef>
 #include <memory>
 #include <map>
@@ -12,6 +13,7 @@
 
 #include "sdl_wrappers.h"
 #include "animation.h"
+#include "calendar.h"
 #include "creature.h"
 #include "lightmap.h"
 #include "line.h"
@@ -21,11 +23,13 @@
 #include "enums.h"
 #include "weighted_list.h"
 #include "point.h"
+#include "type_id.h"
 
 class Creature;
 class player;
 class pixel_minimap;
 class JsonObject;
+struct mtype;
 
 using itype_id = std::string;
 
@@ -274,6 +278,8 @@ class cata_tiles
 
     public:
         void on_options_changed();
+        /** Forgets which tiles ids resolved to, needed when the game data changes. */
+        void clear_resolved_tiles();
 
         /** Draw to screen */
         void draw( const point &dest, const tripoint &center, int width, int height,
@@ -287,20 +293,32 @@ class cata_tiles
         /** How many rows and columns of tiles fit into given dimensions **/
         void get_window_tile_counts( int width, int height, int &columns, int &rows ) const;
 
+        struct resolved_tile;
         const tile_type *find_tile_with_season( std::string &id );
-        const tile_type *find_tile_looks_like( std::string &id, TILE_CATEGORY category );
+        /** Memoized @ref resolve_tile, see @ref resolved_tiles. */
+        const resolved_tile &find_tile_looks_like( const std::string &id, TILE_CATEGORY category );
+        resolved_tile resolve_tile( const std::string &id, TILE_CATEGORY category );
+        const tile_type *resolve_tile_looks_like( std::string &id, TILE_CATEGORY category );
+        /** Like @ref find_tile_looks_like, but by int id: only looks the type up in an array. */
+        const resolved_tile &find_terrain_tile( const ter_id &ter );
+        const resolved_tile &find_furniture_tile( const furn_id &furn );
+        const resolved_tile &find_monster_tile( const mtype &type );
         bool find_overlay_looks_like( bool male, const std::string &overlay, std::string &draw_id );
 
-        bool draw_from_id_string( std::string id, const tripoint &pos, int subtile, int rota, lit_level ll,
-                                  bool apply_night_vision_goggles );
-        bool draw_from_id_string( std::string id, TILE_CATEGORY category,
+        bool draw_from_id_string( const std::string &id, const tripoint &pos, int subtile, int rota,
+                                  lit_level ll, bool apply_night_vision_goggles );
+        bool draw_from_id_string( const std::string &id, TILE_CATEGORY category,
                                   const std::string &subcategory, const tripoint &pos, int subtile, int rota,
                                   lit_level ll, bool apply_night_vision_goggles );
-        bool draw_from_id_string( std::string id, const tripoint &pos, int subtile, int rota, lit_level ll,
-                                  bool apply_night_vision_goggles, int &height_3d );
-        bool draw_from_id_string( std::string id, TILE_CATEGORY category,
+        bool draw_from_id_string( const std::string &id, const tripoint &pos, int subtile, int rota,
+                                  lit_level ll, bool apply_night_vision_goggles, int &height_3d );
+        bool draw_from_id_string( const std::string &id, TILE_CATEGORY category,
                                   const std::string &subcategory, const tripoint &pos, int subtile, int rota,
                                   lit_level ll, bool apply_night_vision_goggles, int &height_3d );
+        /** Draws a tile that was found, the id strings are only used if a multitile part is missing. */
+        bool draw_resolved_tile( const resolved_tile &tile, TILE_CATEGORY category,
+                                 const std::string &subcategory, const tripoint &pos, int subtile, int rota,
+                                 lit_level ll, bool apply_night_vision_goggles, int &height_3d );
         bool draw_sprite_at(
             const tile_type &tile, const weighted_int_list<std::vector<int>> &svlist,
             const point &, unsigned int loc_rand, bool rota_fg, int rota, lit_level ll,
@@ -498,6 +516,27 @@ class cata_tiles
         const SDL_Renderer_Ptr &renderer;
         std::unique_ptr<tileset> tileset_ptr;
 
+        /** The tile an id resolved to (after looks_like and season), nullptr if none. */
+        struct resolved_tile {
+            const tile_type *tt = nullptr;
+            /** The id of @ref tt. */
+            std::string id;
+            /** The tiles of the multitile parts @ref tt has, by MULTITILE_TYPE. */
+            std::array<const tile_type *, num_multitile_types> subtiles = {{}};
+        };
+        /** What ids resolved to in one season, only valid for the loaded tileset and game data. */
+        struct resolved_tile_tables {
+            /** By category and id string, including the ids that found no tile. */
+            std::map<TILE_CATEGORY, std::unordered_map<std::string, resolved_tile>> by_id;
+            /** Filled for all types at once on first use, indexed by int id. */
+            std::vector<resolved_tile> terrain;
+            std::vector<resolved_tile> furniture;
+            std::vector<resolved_tile> monsters;
+        };
+        std::array<resolved_tile_tables, NUM_SEASONS> resolved_tiles;
+        /** The season tiles are resolved for, updated when drawing starts. */
+        season_type resolved_season = SPRING;
+
         int tile_height = 0;
         int tile_width = 0;
         // The width and height of the area we can draw in,
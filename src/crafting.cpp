@@ -483,13 +483,10 @@ bool player::can_make( const recipe *r, int batch_size )
             batch_size );
 }
 
-bool player::can_start_craft( const recipe *rec, int batch_size )
+// The requirements to start crafting, for the first 5% progress.
+static requirement_data start_requirements( const recipe &rec, int batch_size )
 {
-    if( !rec ) {
-        return false;
-    }
-
-    const std::vector<std::vector<tool_comp>> &tool_reqs = rec->requirements().get_tools();
+    const std::vector<std::vector<tool_comp>> &tool_reqs = rec.requirements().get_tools();
 
     // For tools adjust the reqired charges
     std::vector<std::vector<tool_comp>> adjusted_tool_reqs;
@@ -507,7 +504,7 @@ bool player::can_start_craft( const recipe *rec, int batch_size )
         adjusted_tool_reqs.push_back( adjusted_alternatives );
     }
 
-    const std::vector<std::vector<item_comp>> &comp_reqs = rec->requirements().get_components();
+    const std::vector<std::vector<item_comp>> &comp_reqs = rec.requirements().get_components();
 
     // For components we need to multiply by batch size to stay even with tools
     std::vector<std::vector<item_comp>> adjusted_comp_reqs;
@@ -522,11 +519,37 @@ bool player::can_start_craft( const recipe *rec, int batch_size )
     }
 
     // Qualities don't need adjustment
-    const requirement_data start_reqs( adjusted_tool_reqs,
-                                       rec->requirements().get_qualities(),
-                                       adjusted_comp_reqs );
+    return requirement_data( adjusted_tool_reqs, rec.requirements().get_qualities(),
+                             adjusted_comp_reqs );
+}
+
+bool player::can_start_craft( const recipe *rec, int batch_size )
+{
+    if( !rec ) {
+        return false;
+    }
+
+    return start_requirements( *rec, batch_size ).can_make_with_inventory( crafting_inventory(),
+            rec->get_component_filter() );
+}
 
-    return start_reqs.can_make_with_inventory( crafting_inventory(), rec->get_component_filter() );
+std::vector<bool> player::can_start_crafts( const std::vector<const recipe *> &recipes )
+{
+    // Forming the crafting inventory anew drops the results of earlier calls.
+    const inventory &crafting_inv = crafting_inventory();
+    requirement_check_cache checks;
+    std::vector<bool> result;
+    result.reserve( recipes.size() );
+    for( const recipe *rec : recipes ) {
+        auto iter = cached_start_craft.find( rec );
+        if( iter == cached_start_craft.end() ) {
+            const bool can_start = rec && start_requirements( *rec, 1 ).can_make_with_inventory(
+                                       crafting_inv, rec->get_component_filter(), 1, &checks );
+            iter = cached_start_craft.emplace( rec, can_start ).first;
+        }
+        result.push_back( iter->second );
+    }
+    return result;
 }
 
 const inventory &player::crafting_inventory( const tripoint &src_pos, int radius )
@@ -537,9 +560,11 @@ const inventory &player::crafting_inventory( const tripoint &src_pos, int radius
     }
     if( cached_moves == moves
         && cached_time == calendar::turn
-        && cached_position == inv_pos ) {
+        && cached_position == inv_pos
+        && cached_radius == radius ) {
         return cached_crafting_inventory;
     }
+    cached_start_craft.clear();
     cached_crafting_inventory.form_from_map( inv_pos, radius, this, false, true );
     cached_crafting_inventory += inv;
     cached_crafting_inventory += weapon;
@@ -560,6 +585,7 @@ const inventory &player::crafting_inventory( const tripoint &src_pos, int radius
     cached_moves = moves;
     cached_time = calendar::turn;
     cached_position = inv_pos;
+    cached_radius = radius;
     return cached_crafting_inventory;
 }
 
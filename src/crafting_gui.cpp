@@ -363,11 +363,16 @@ const recipe *select_crafting_recipe( int &batch_size )
 
                 available.reserve( current.size() );
                 // cache recipe availability on first display
+                std::vector<const recipe *> unknown;
                 for( const auto e : current ) {
                     if( !availability_cache.count( e ) ) {
-                        availability_cache.emplace( e, g->u.can_start_craft( e ) );
+                        unknown.push_back( e );
                     }
                 }
+                const std::vector<bool> can_start = g->u.can_start_crafts( unknown );
+                for( size_t i = 0; i < unknown.size(); ++i ) {
+                    availability_cache.emplace( unknown[i], can_start[i] );
+                }
 
                 if( subtab.cur() != "CSC_*_RECENT" ) {
                     std::stable_sort( current.begin(), current.end(), []( const recipe * a, const recipe * b ) {
@@ -1,11 +1,15 @@
 #include "creature_tracker.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <utility>
 
+#include "coordinate_conversions.h"
 #include "debug.h"
+#include "game_constants.h"
+#include "line.h"
 #include "mongroup.h"
 #include "monster.h"
 #include "mtype.h"
@@ -84,7 +88,7 @@ bool Creature_tracker::add( std::shared_ptr<monster> critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.pos()] = critter_ptr;
+    add_to_location_map( critter.pos(), critter_ptr );
     add_to_faction_map( critter_ptr );
     return true;
 }
@@ -134,8 +138,11 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( critter.pos() );
-        monsters_by_location[new_pos] = *iter;
+        const auto pos_iter = monsters_by_location.find( critter.pos() );
+        if( pos_iter != monsters_by_location.end() ) {
+            erase_from_location_map( pos_iter );
+        }
+        add_to_location_map( new_pos, *iter );
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -154,7 +161,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.pos() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_from_location_map( pos_iter );
         return;
     }
 
@@ -165,8 +172,105 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_from_location_map( iter );
+    }
+}
+
+void Creature_tracker::add_to_location_map( const tripoint &pos,
+        const std::shared_ptr<monster> &critter )
+{
+    std::shared_ptr<monster> &slot = monsters_by_location[pos];
+    if( slot ) {
+        // Overwriting another entry, that one must not linger in its bucket.
+        std::vector<std::shared_ptr<monster>> &bucket = monsters_by_submap[ms_to_sm_copy( pos )];
+        bucket.erase( std::remove( bucket.begin(), bucket.end(), slot ), bucket.end() );
+    }
+    slot = critter;
+    monsters_by_submap[ms_to_sm_copy( pos )].push_back( critter );
+}
+
+void Creature_tracker::erase_from_location_map(
+    const std::unordered_map<tripoint, std::shared_ptr<monster>>::const_iterator iter )
+{
+    const auto bucket_iter = monsters_by_submap.find( ms_to_sm_copy( iter->first ) );
+    if( bucket_iter != monsters_by_submap.end() ) {
+        std::vector<std::shared_ptr<monster>> &bucket = bucket_iter->second;
+        bucket.erase( std::remove( bucket.begin(), bucket.end(), iter->second ), bucket.end() );
+        if( bucket.empty() ) {
+            monsters_by_submap.erase( bucket_iter );
+        }
+    }
+    monsters_by_location.erase( iter );
+}
+
+bool Creature_tracker::sees_this_turn( const monster &observer, const Creature &target )
+{
+    if( sees_memo_turn != calendar::turn ) {
+        sees_memo.clear();
+        sees_memo_turn = calendar::turn;
+    }
+    const sees_key key( &observer, observer.pos(), &target, target.pos() );
+    const auto iter = sees_memo.find( key );
+    if( iter != sees_memo.end() ) {
+        return iter->second;
+    }
+    const bool result = observer.sees( target );
+    sees_memo.emplace( key, result );
+    return result;
+}
+
+std::vector<monster *> Creature_tracker::find_in_radius( const tripoint &center,
+        const int radius ) const
+{
+    return find_in_radius( center, radius, []( const monster & ) {
+        return true;
+    } );
+}
+
+std::vector<monster *> Creature_tracker::find_in_radius( const tripoint &center, const int radius,
+        const std::function<bool( const monster & )> &filter ) const
+{
+    std::vector<monster *> result;
+    if( radius < 0 ) {
+        return result;
+    }
+    const tripoint min_sm = ms_to_sm_copy( center - tripoint( radius, radius, 0 ) );
+    const tripoint max_sm = ms_to_sm_copy( center + tripoint( radius, radius, 0 ) );
+    const int min_z = std::max( center.z - radius, -OVERMAP_DEPTH );
+    const int max_z = std::min( center.z + radius, OVERMAP_HEIGHT );
+    const auto in_range = [&]( const std::shared_ptr<monster> &mon_ptr ) {
+        return !mon_ptr->is_dead() && rl_dist( center, mon_ptr->pos() ) <= radius && filter( *mon_ptr );
+    };
+
+    const int64_t buckets = static_cast<int64_t>( max_sm.x - min_sm.x + 1 ) *
+                            ( max_sm.y - min_sm.y + 1 ) * ( max_z - min_z + 1 );
+    if( buckets > static_cast<int64_t>( monsters_by_submap.size() ) ) {
+        // Looking up every bucket would be more work than checking each monster.
+        for( const std::shared_ptr<monster> &mon_ptr : monsters_list ) {
+            if( in_range( mon_ptr ) ) {
+                result.push_back( mon_ptr.get() );
+            }
+        }
+        return result;
+    }
+
+    tripoint sm;
+    for( sm.z = min_z; sm.z <= max_z; sm.z++ ) {
+        for( sm.y = min_sm.y; sm.y <= max_sm.y; sm.y++ ) {
+            for( sm.x = min_sm.x; sm.x <= max_sm.x; sm.x++ ) {
+                const auto bucket_iter = monsters_by_submap.find( sm );
+                if( bucket_iter == monsters_by_submap.end() ) {
+                    continue;
+                }
+                for( const std::shared_ptr<monster> &mon_ptr : bucket_iter->second ) {
+                    if( in_range( mon_ptr ) ) {
+                        result.push_back( mon_ptr.get() );
+                    }
+                }
+            }
+        }
     }
+    return result;
 }
 
 void Creature_tracker::remove( const monster &critter )
@@ -192,22 +296,26 @@ void Creature_tracker::remove( const monster &critter )
     remove_from_location_map( critter );
     removed_.push_back( *iter );
     monsters_list.erase( iter );
+    sees_memo.clear();
 }
 
 void Creature_tracker::clear()
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     monster_faction_map_.clear();
     removed_.clear();
+    sees_memo.clear();
 }
 
 void Creature_tracker::rebuild_cache()
 {
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     monster_faction_map_.clear();
     for( const std::shared_ptr<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        add_to_location_map( mon_ptr->pos(), mon_ptr );
         add_to_faction_map( mon_ptr );
     }
 }
@@ -226,13 +334,13 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     std::shared_ptr<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
+        erase_from_location_map( first_iter );
     }
 
     std::shared_ptr<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
+        erase_from_location_map( second_iter );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -242,10 +350,10 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.pos()] = first_ptr;
+        add_to_location_map( first.pos(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.pos()] = second_ptr;
+        add_to_location_map( second.pos(), second_ptr );
     }
 }
 
@@ -281,6 +389,7 @@ void Creature_tracker::remove_dead()
         if( critter.is_dead() ) {
             remove_from_location_map( critter );
             iter = monsters_list.erase( iter );
+            sees_memo.clear();
         } else {
             ++iter;
         }
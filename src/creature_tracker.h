@@ -3,14 +3,19 @@
 #define CREATURE_TRACKER_H
 
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <set>
+#include <tuple>
 #include <vector>
 
+#include "calendar.h"
+#include "hash_utils.h"
 #include "point.h"
 #include "type_id.h"
 
+class Creature;
 class monster;
 class JsonIn;
 class JsonOut;
@@ -77,6 +82,23 @@ class Creature_tracker
         /** Removes dead monsters from. Their pointers are invalidated. */
         void remove_dead();
 
+        /**
+         * Returns all living monsters within @p radius (as measured by @ref rl_dist) of @p center.
+         * Only the submap buckets overlapping that radius are looked at. The result is ordered
+         * by bucket and thereby deterministic for a given set of monster positions.
+         */
+        std::vector<monster *> find_in_radius( const tripoint &center, int radius ) const;
+        /** Like the above, but only returns the monsters @p filter accepts. */
+        std::vector<monster *> find_in_radius( const tripoint &center, int radius,
+                                               const std::function<bool( const monster & )> &filter ) const;
+
+        /**
+         * Result of `observer.sees( target )`, remembered for the rest of the turn. Several
+         * monsters rating the same targets (and the same monster rating the player both in
+         * plan and in rate_target) would otherwise repeat the same line of sight checks.
+         */
+        bool sees_this_turn( const monster &observer, const Creature &target );
+
         const std::vector<std::shared_ptr<monster>> &get_monsters_list() const {
             return monsters_list;
         }
@@ -91,8 +113,25 @@ class Creature_tracker
     private:
         std::vector<std::shared_ptr<monster>> monsters_list;
         std::unordered_map<tripoint, std::shared_ptr<monster>> monsters_by_location;
+        /**
+         * Same content as @ref monsters_by_location, but bucketed by the submap (in map square
+         * coordinates relative to the reality bubble) the location is in. Used for radius queries.
+         */
+        std::unordered_map<tripoint, std::vector<std::shared_ptr<monster>>> monsters_by_submap;
+        /**
+         * Memo of @ref sees_this_turn, by observer and target and their positions. The pointers
+         * are only compared, it is cleared whenever a monster is removed or the turn changes.
+         */
+        using sees_key = std::tuple<const monster *, tripoint, const Creature *, tripoint>;
+        std::unordered_map<sees_key, bool, cata::tuple_hash> sees_memo;
+        time_point sees_memo_turn = calendar::before_time_starts;
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+        /** Adds the monster to @ref monsters_by_location and @ref monsters_by_submap */
+        void add_to_location_map( const tripoint &pos, const std::shared_ptr<monster> &critter );
+        /** Removes the entry from @ref monsters_by_location and @ref monsters_by_submap */
+        void erase_from_location_map(
+            std::unordered_map<tripoint, std::shared_ptr<monster>>::const_iterator iter );
 };
 
 #endif
@@ -0,0 +1,173 @@
+#include "data_cache.h"
+
+#include <sys/stat.h>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include "cata_utility.h"
+#include "debug.h"
+#include "filesystem.h"
+#include "get_version.h"
+#include "omdata.h"
+#include "path_info.h"
+
+static const std::string cache_magic = "CDDADAT2";
+
+namespace data_cache
+{
+
+void writer::write_uint( uint64_t value, const int bytes )
+{
+    for( int i = 0; i < bytes; i++ ) {
+        fout.put( static_cast<char>( value & 0xff ) );
+        value >>= 8;
+    }
+}
+
+void writer::write_int( const int value )
+{
+    write_uint( static_cast<uint32_t>( value ), 4 );
+}
+
+void writer::write_bool( const bool value )
+{
+    write_uint( value ? 1 : 0, 1 );
+}
+
+void writer::write_string( const std::string &str )
+{
+    write_uint( str.size(), 4 );
+    fout.write( str.data(), str.size() );
+}
+
+uint64_t reader::read_uint( const int bytes )
+{
+    require( bytes );
+    uint64_t value = 0;
+    for( int i = 0; i < bytes; i++ ) {
+        value |= static_cast<uint64_t>( static_cast<unsigned char>( data[pos++] ) ) << ( 8 * i );
+    }
+    return value;
+}
+
+int reader::read_int()
+{
+    return static_cast<int>( static_cast<uint32_t>( read_uint( 4 ) ) );
+}
+
+bool reader::read_bool()
+{
+    return read_uint( 1 ) != 0;
+}
+
+std::string reader::read_string()
+{
+    return read_chars( read_uint( 4 ) );
+}
+
+std::string reader::read_chars( const size_t length )
+{
+    require( length );
+    std::string result = data.substr( pos, length );
+    pos += length;
+    return result;
+}
+
+void reader::require( const size_t bytes ) const
+{
+    if( data.size() - pos < bytes ) {
+        throw std::runtime_error( "unexpected end of data cache" );
+    }
+}
+
+const std::vector<cached_type> &cached_types()
+{
+    static const std::vector<cached_type> types = {
+        {
+            "overmap_land_use_code", &overmap_land_use_codes::reset,
+            &overmap_land_use_codes::save_cache, &overmap_land_use_codes::load_cache
+        },
+    };
+    return types;
+}
+
+const cached_type *find_cached_type( const std::string &json_type )
+{
+    for( const cached_type &type : cached_types() ) {
+        if( type.json_type == json_type ) {
+            return &type;
+        }
+    }
+    return nullptr;
+}
+
+static std::string cache_path( const cached_type &type )
+{
+    return FILENAMES["datacachedir"] + type.json_type + ".bin";
+}
+
+std::string key_of( const std::vector<std::string> &files )
+{
+    std::ostringstream key;
+    key << getVersionString() << '\n';
+    for( const std::string &file : files ) {
+        struct stat info;
+        if( stat( file.c_str(), &info ) != 0 ) {
+            key << file << " ?\n";
+        } else {
+            key << file << ' ' << info.st_size << ' ' << info.st_mtime << '\n';
+        }
+    }
+    return key.str();
+}
+
+bool load( const cached_type &type, const std::string &key )
+{
+    type.reset();
+    std::ifstream fin( cache_path( type ), std::ios::binary );
+    if( !fin.is_open() ) {
+        return false;
+    }
+    const std::string data( ( std::istreambuf_iterator<char>( fin ) ),
+                            std::istreambuf_iterator<char>() );
+    try {
+        reader in( data );
+        if( in.read_chars( cache_magic.size() ) != cache_magic || in.read_string() != key ) {
+            return false;
+        }
+        type.load( in );
+        if( !in.at_end() ) {
+            throw std::runtime_error( "trailing data in data cache" );
+        }
+    } catch( const std::exception &err ) {
+        DebugLog( D_WARNING, DC_ALL ) << "ignoring data cache of " << type.json_type << ": " <<
+                                      err.what();
+        type.reset();
+        return false;
+    }
+    return true;
+}
+
+void save( const cached_type &type, const std::string &key )
+{
+    if( !assure_dir_exist( FILENAMES["datacachedir"] ) ) {
+        DebugLog( D_WARNING, DC_ALL ) << "can't create " << FILENAMES["datacachedir"];
+        return;
+    }
+    try {
+        write_to_file( cache_path( type ), [&]( std::ostream & fout ) {
+            fout.write( cache_magic.data(), cache_magic.size() );
+            writer out( fout );
+            out.write_string( key );
+            type.save( out );
+        } );
+    } catch( const std::exception &err ) {
+        DebugLog( D_WARNING, DC_ALL ) << "writing data cache of " << type.json_type << " failed: " <<
+                                      err.what();
+    }
+}
+
+} // namespace data_cache
@@ -0,0 +1,93 @@
+#pragma once
+#ifndef DATA_CACHE_H
+#define DATA_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Opt-in cache (see the DATA_CACHE option) of the finalized objects of some types, stored in
+ * one binary file per type. While the cache is on, the JSON objects of those types are put
+ * aside while loading the data files. When all data is loaded, the objects are read from
+ * the cache instead, which skips loading and finalizing them. If there is no usable cache,
+ * the objects put aside are loaded as usual and the cache is written after finalizing.
+ *
+ * A cache file is only used if the game version and the names, sizes and modification times
+ * of all loaded data files are the same as when it was written. All numbers are stored
+ * little-endian.
+ */
+namespace data_cache
+{
+
+class writer
+{
+    public:
+        explicit writer( std::ostream &fout ) : fout( fout ) {}
+
+        void write_uint( uint64_t value, int bytes );
+        void write_int( int value );
+        void write_bool( bool value );
+        void write_string( const std::string &str );
+
+    private:
+        std::ostream &fout;
+};
+
+/** Reads what @ref writer wrote, throws std::runtime_error on reaching the end of the data. */
+class reader
+{
+    public:
+        explicit reader( const std::string &data ) : data( data ) {}
+
+        uint64_t read_uint( int bytes );
+        int read_int();
+        bool read_bool();
+        std::string read_string();
+        std::string read_chars( size_t length );
+        bool at_end() const {
+            return pos == data.size();
+        }
+
+    private:
+        void require( size_t bytes ) const;
+
+        const std::string &data;
+        size_t pos = 0;
+};
+
+/** A type whose finalized objects can be stored in the cache. */
+struct cached_type {
+    /** The "type" of its JSON objects, also names the cache file. */
+    std::string json_type;
+    /** Removes all objects. */
+    std::function<void()> reset;
+    /** Writes all loaded objects. */
+    std::function<void( writer & )> save;
+    /** Adds the objects read after a reset, may throw on broken data. */
+    std::function<void( reader & )> load;
+};
+
+/** The types stored in the cache. */
+const std::vector<cached_type> &cached_types();
+/** The cached type of JSON objects of type @p json_type, or nullptr if it isn't cached. */
+const cached_type *find_cached_type( const std::string &json_type );
+
+/** Describes the files and the game version, compared with the key stored in the cache. */
+std::string key_of( const std::vector<std::string> &files );
+
+/**
+ * Loads the objects of @p type from the cache if it was written with @p key.
+ * Returns false, and leaves the objects reset, if there is no such cache or it is broken.
+ */
+bool load( const cached_type &type, const std::string &key );
+
+/** Replaces the cache of @p type, failing to do so is only logged. */
+void save( const cached_type &type, const std::string &key );
+
+} // namespace data_cache
+
+#endif
@@ -28,6 +28,7 @@
 #include "filesystem.h"
 #include "game.h"
 #include "map_extras.h"
+#include "mapbuffer.h"
 #include "messages.h"
 #include "mission.h"
 #include "morale_types.h"
@@ -146,7 +147,8 @@ enum debug_menu_index {
     DEBUG_DISPLAY_LIGHTING,
     DEBUG_DISPLAY_RADIATION,
     DEBUG_LEARN_SPELLS,
-    DEBUG_LEVEL_SPELLS
+    DEBUG_LEVEL_SPELLS,
+    DEBUG_CONVERT_MAP_FILES
 };
 
 class mission_debug
@@ -259,6 +261,7 @@ static int map_uilist()
         { uilist_entry( DEBUG_CHANGE_TIME, true, 't', _( "Change time" ) ) },
         { uilist_entry( DEBUG_OM_EDITOR, true, 'O', _( "Overmap editor" ) ) },
         { uilist_entry( DEBUG_MAP_EXTRA, true, 'm', _( "Spawn map extra" ) ) },
+        { uilist_entry( DEBUG_CONVERT_MAP_FILES, true, 'c', _( "Convert saved map files" ) ) },
     };
 
     return uilist( _( "Map…" ), uilist_initializer );
@@ -1553,6 +1556,16 @@ void debug()
                 g->uquit = QUIT_NOSAVED;
             }
             break;
+        case DEBUG_CONVERT_MAP_FILES: {
+            const bool to_segments = get_option<bool>( "SEGMENTED_MAP_FILES" );
+            if( query_yn( to_segments ?
+                          _( "Convert all saved map quads into segment files?" ) :
+                          _( "Convert all map segment files into quad files?" ) ) ) {
+                MAPBUFFER.save();
+                MAPBUFFER.convert_map_files( to_segments );
+            }
+        }
+        break;
         case DEBUG_TEST_WEATHER: {
             weather_generator weathergen;
             weathergen.test_weather();
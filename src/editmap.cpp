@@ -2,7 +2,6 @@
 
 #include <algorithm>
 #include <cstdlib>
-#include <cstring>
 #include <map>
 #include <string>
 #include <vector>
@@ -1954,7 +1953,7 @@ void editmap::cleartmpmap( tinymap &tmpmap )
     }
 
     auto &ch = tmpmap.get_cache( target.z );
-    std::memset( ch.veh_exists_at, 0, sizeof( ch.veh_exists_at ) );
+    std::fill_n( &ch.veh_cached_at[0][0], MAPSIZE_X * MAPSIZE_Y, std::make_pair( nullptr, -1 ) );
     ch.veh_cached_parts.clear();
     ch.vehicle_list.clear();
     ch.zone_vehicles.clear();
@@ -32,6 +32,7 @@
 #include "auto_pickup.h"
 #include "avatar.h"
 #include "avatar_action.h"
+#include "background_writer.h"
 #include "bionics.h"
 #include "bodypart.h"
 #include "cata_utility.h"
@@ -1229,6 +1230,12 @@ bool game::cleanup_at_end()
     sfx::fade_audio_group( sfx::group::context_themes, 300 );
     sfx::fade_audio_group( sfx::group::fatigue, 300 );
 
+    // The map files may still be written, they must be complete before the world is left.
+    try {
+        get_save_writer().flush();
+    } catch( const std::exception &err ) {
+        popup( _( "Failed to save the maps: %s" ), err.what() );
+    }
     MAPBUFFER.reset();
     overmap_buffer.clear();
 
@@ -1372,7 +1379,7 @@ bool game::do_turn()
     }
 
     // starting a new turn, clear out temperature cache
-    weather.temperature_cache.clear();
+    weather.clear_temp_cache();
 
     if( npcs_dirty ) {
         load_npcs();
@@ -1529,6 +1536,7 @@ bool game::do_turn()
     m.process_fields();
     m.process_active_items();
     m.creature_in_field( u );
+    m.release_empty_tiles();
 
     // Apply sounds from previous turn to monster and NPC AI.
     sounds::process_sounds();
@@ -2763,6 +2771,12 @@ void game::load_world_modfiles( loading_ui &ui )
     catacurses::refresh();
 
     DynamicDataLoader::get_instance().finalize_loaded_data( ui );
+#if defined(TILES)
+    // Tests load the world data without any tiles context.
+    if( tilecontext ) {
+        tilecontext->clear_resolved_tiles();
+    }
+#endif
 }
 
 bool game::load_packs( const std::string &msg, const std::vector<mod_id> &packs, loading_ui &ui )
@@ -2849,6 +2863,8 @@ bool game::save_artifacts()
 bool game::save_maps()
 {
     try {
+        // Report failures of the files still written by the previous save.
+        get_save_writer().rethrow_errors();
         m.save();
         overmap_buffer.save(); // can throw
         MAPBUFFER.save(); // can throw
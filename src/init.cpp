@@ -2,12 +2,13 @@
 
 #include <cstddef>
 #include <cassert>
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <sstream> // for throwing errors
 #include <string>
 #include <vector>
 #include <exception>
-#include <iterator>
 #include <memory>
 #include <stdexcept>
 
@@ -19,6 +20,7 @@
 #include "construction.h"
 #include "crafting_gui.h"
 #include "creature.h"
+#include "data_cache.h"
 #include "debug.h"
 #include "dialogue.h"
 #include "effect.h"
@@ -51,6 +53,7 @@
 #include "npc.h"
 #include "npc_class.h"
 #include "omdata.h"
+#include "options.h"
 #include "overlay_ordering.h"
 #include "overmap_connection.h"
 #include "overmap_location.h"
@@ -68,6 +71,7 @@
 #include "speech.h"
 #include "start_location.h"
 #include "string_formatter.h"
+#include "thread_pool.h"
 #include "text_snippets.h"
 #include "trap.h"
 #include "tutorial.h"
@@ -114,8 +118,7 @@ void DynamicDataLoader::load_deferred( deferred_json &data )
         auto it = data.begin();
         for( size_t idx = 0; idx != n; ++idx ) {
             try {
-                std::istringstream str( it->first );
-                JsonIn jsin( str );
+                JsonIn jsin( it->first );
                 JsonObject jo = jsin.get_object();
                 load_object( jo, it->second );
             } catch( const std::exception &err ) {
@@ -389,6 +392,55 @@ void DynamicDataLoader::initialize()
 #endif
 }
 
+namespace
+{
+// A data file read into memory, with the objects in it located.
+struct indexed_json_file {
+    std::string content;
+    std::vector<JsonObject::member_index> objects;
+    // What stopped the indexing, after the objects before the error.
+    std::string error;
+    std::chrono::microseconds index_time = std::chrono::microseconds( 0 );
+};
+} // namespace
+
+// Does the work of load_all_from_json that doesn't need the loaders, on any thread.
+static void index_json_file( const std::string &file, indexed_json_file &result )
+{
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        // open the file as a stream
+        std::ifstream infile( file.c_str(), std::ifstream::in | std::ifstream::binary );
+        // and read it into ram in one go, it is parsed straight from there
+        infile.seekg( 0, std::ifstream::end );
+        result.content.assign( std::max<std::streamoff>( infile.tellg(), 0 ), '\0' );
+        infile.seekg( 0 );
+        infile.read( &result.content[0], result.content.size() );
+        JsonIn jsin( result.content );
+        if( jsin.test_object() ) {
+            result.objects.push_back( JsonObject::index_members( jsin ) );
+            // if there's anything else in the file, it's an error.
+            jsin.eat_whitespace();
+            if( jsin.good() ) {
+                jsin.error( string_format( "expected single-object file but found '%c'", jsin.peek() ) );
+            }
+        } else if( jsin.test_array() ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                result.objects.push_back( JsonObject::index_members( jsin ) );
+            }
+        } else {
+            // not an object or an array?
+            jsin.error( "expected object or array" );
+        }
+    } catch( const std::exception &err ) {
+        // Not only JsonError, nothing may escape the worker thread
+        result.error = err.what();
+    }
+    result.index_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start );
+}
+
 void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src,
         loading_ui &ui )
 {
@@ -409,25 +461,43 @@ void DynamicDataLoader::load_data_from_path( const std::string &path, const std:
             files.push_back( path );
         }
     }
-    // iterate over each file
-    for( auto &files_i : files ) {
-        const std::string &file = files_i;
-        // open the file as a stream
-        std::ifstream infile( file.c_str(), std::ifstream::in | std::ifstream::binary );
-        // and stuff it into ram
-        std::istringstream iss(
-            std::string(
-                ( std::istreambuf_iterator<char>( infile ) ),
-                std::istreambuf_iterator<char>()
-            )
-        );
+    use_data_cache = get_option<bool>( "DATA_CACHE" );
+    loaded_files.insert( loaded_files.end(), files.begin(), files.end() );
+    // Reading the files and finding the objects in them is independent of everything else,
+    // so it is done for all files at once. The objects are loaded in the original order.
+    std::vector<indexed_json_file> indexed( files.size() );
+    parallel_for( static_cast<int>( files.size() ), [&]( const int i ) {
+        index_json_file( files[i], indexed[i] );
+    } );
+    for( size_t i = 0; i < files.size(); i++ ) {
+        const std::string &file = files[i];
+        indexed_json_file &current = indexed[i];
+        const auto start = std::chrono::steady_clock::now();
         try {
-            // parse it
-            JsonIn jsin( iss );
-            load_all_from_json( jsin, src, ui, path, file );
+            JsonIn jsin( current.content );
+            for( JsonObject::member_index &index : current.objects ) {
+                JsonObject jo( jsin, std::move( index ) );
+                if( use_data_cache ) {
+                    std::string type = jo.get_string( "type" );
+                    if( data_cache::find_cached_type( type ) != nullptr ) {
+                        cached_type_objects.push_back( { std::move( type ), jo.str(), src, file } );
+                        continue;
+                    }
+                }
+                load_object( jo, src, path, file );
+                jo.finish();
+            }
+            if( !current.error.empty() ) {
+                throw JsonError( current.error );
+            }
         } catch( const JsonError &err ) {
             throw std::runtime_error( file + ": " + err.what() );
         }
+        ui.add_timing( file, current.index_time +
+                       std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start ) );
+        // Free the memory as soon as possible, all files may be large together.
+        current = indexed_json_file();
     }
 }
 
@@ -461,6 +531,9 @@ void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src
 void DynamicDataLoader::unload_data()
 {
     finalized = false;
+    loaded_files.clear();
+    cached_type_objects.clear();
+    types_from_cache.clear();
 
     harvest_list::reset();
     json_flag::reset();
@@ -541,9 +614,37 @@ void DynamicDataLoader::finalize_loaded_data()
     finalize_loaded_data( ui );
 }
 
+void DynamicDataLoader::load_cached_types()
+{
+    if( use_data_cache ) {
+        const std::string key = data_cache::key_of( loaded_files );
+        for( const data_cache::cached_type &type : data_cache::cached_types() ) {
+            if( data_cache::load( type, key ) ) {
+                types_from_cache.insert( type.json_type );
+            }
+        }
+    }
+    for( cached_type_object &obj : cached_type_objects ) {
+        if( loaded_from_cache( obj.type ) ) {
+            continue;
+        }
+        try {
+            JsonIn jsin( obj.json );
+            JsonObject jo = jsin.get_object();
+            load_object( jo, obj.src );
+            jo.finish();
+        } catch( const JsonError &err ) {
+            throw std::runtime_error( obj.file + ": " + err.what() );
+        }
+    }
+    cached_type_objects.clear();
+}
+
 void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
 {
     assert( !finalized && "Can't finalize the data twice." );
+    load_cached_types();
+    ui.report_timings();
     ui.new_context( _( "Finalizing" ) );
 
     using named_entry = std::pair<std::string, std::function<void()>>;
@@ -568,7 +669,14 @@ void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
             { _( "Bionics" ), &finalize_bionics },
             { _( "Terrain" ), &set_ter_ids },
             { _( "Furniture" ), &set_furn_ids },
-            { _( "Overmap land use codes" ), &overmap_land_use_codes::finalize },
+            {
+                _( "Overmap land use codes" ), [this]()
+                {
+                    if( !loaded_from_cache( "overmap_land_use_code" ) ) {
+                        overmap_land_use_codes::finalize();
+                    }
+                }
+            },
             { _( "Overmap terrain" ), &overmap_terrains::finalize },
             { _( "Overmap connections" ), &overmap_connections::finalize },
             { _( "Overmap specials" ), &overmap_specials::finalize },
@@ -609,6 +717,14 @@ void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
     }
 
     check_consistency( ui );
+    if( use_data_cache ) {
+        const std::string key = data_cache::key_of( loaded_files );
+        for( const data_cache::cached_type &type : data_cache::cached_types() ) {
+            if( !loaded_from_cache( type.json_type ) ) {
+                data_cache::save( type, key );
+            }
+        }
+    }
     finalized = true;
 }
 
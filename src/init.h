@@ -5,6 +5,7 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <utility>
@@ -66,6 +67,30 @@ class DynamicDataLoader
     private:
         bool finalized = false;
 
+        /** An object of a type in the data cache, put aside while loading the data files. */
+        struct cached_type_object {
+            std::string type;
+            std::string json;
+            std::string src;
+            std::string file;
+        };
+        /** Whether the objects of types in the data cache are put aside, see @ref data_cache. */
+        bool use_data_cache = false;
+        /** All files read by @ref load_data_from_path, in order, they key the data cache. */
+        str_vec loaded_files;
+        std::vector<cached_type_object> cached_type_objects;
+        /** The types loaded from the data cache, they are not finalized again. */
+        std::set<std::string> types_from_cache;
+
+        /**
+         * Loads the types in the data cache, from the cache if it matches the loaded files, or
+         * from the objects put aside otherwise.
+         */
+        void load_cached_types();
+        bool loaded_from_cache( const std::string &type ) const {
+            return types_from_cache.count( type ) > 0;
+        }
+
     protected:
         /**
          * Maps the type string (coming from json) to the
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <set>
 
 #include "avatar.h"
 #include "debug.h"
@@ -209,6 +210,7 @@ inventory inventory::operator+ ( const item &rhs )
 void inventory::unsort()
 {
     binned = false;
+    qualities_indexed = false;
 }
 
 static bool stack_compare( const std::list<item> &lhs, const std::list<item> &rhs )
@@ -220,6 +222,7 @@ void inventory::clear()
 {
     items.clear();
     binned = false;
+    qualities_indexed = false;
 }
 
 void inventory::push_back( const std::list<item> &newits )
@@ -266,6 +269,7 @@ char inventory::find_usable_cached_invlet( const std::string &item_type )
 item &inventory::add_item( item newit, bool keep_invlet, bool assign_invlet, bool should_stack )
 {
     binned = false;
+    qualities_indexed = false;
 
     if( should_stack ) {
         // See if we can't stack this item.
@@ -327,6 +331,7 @@ void inventory::restack( player &p )
     // 3. combine matching stacks
 
     binned = false;
+    qualities_indexed = false;
     std::list<item> to_restack;
     int idx = 0;
     for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter, ++idx ) {
@@ -593,6 +598,7 @@ std::list<item> inventory::reduce_stack( const int position, const int quantity
     for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter ) {
         if( position == pos ) {
             binned = false;
+            qualities_indexed = false;
             if( quantity >= static_cast<int>( iter->size() ) || quantity < 0 ) {
                 ret = *iter;
                 items.erase( iter );
@@ -615,6 +621,7 @@ item inventory::remove_item( const item *it )
     }, 1 );
     if( !tmp.empty() ) {
         binned = false;
+        qualities_indexed = false;
         return tmp.front();
     }
     debugmsg( "Tried to remove a item not in inventory." );
@@ -627,6 +634,7 @@ item inventory::remove_item( const int position )
     for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter ) {
         if( position == pos ) {
             binned = false;
+            qualities_indexed = false;
             if( iter->size() > 1 ) {
                 std::list<item>::iterator stack_member = iter->begin();
                 char invlet = stack_member->invlet;
@@ -672,6 +680,7 @@ std::list<item> inventory::remove_randomly_by_volume( const units::volume &volum
         }
         if( chosen_stack->empty() ) {
             binned = false;
+            qualities_indexed = false;
             items.erase( chosen_stack );
         }
     }
@@ -759,6 +768,7 @@ std::list<item> inventory::use_amount( itype_id it, int quantity,
         }
         if( iter->empty() ) {
             binned = false;
+            qualities_indexed = false;
             iter = items.erase( iter );
         } else if( iter != items.end() ) {
             ++iter;
@@ -1129,6 +1139,38 @@ const itype_bin &inventory::get_binned_items() const
     return binned_items;
 }
 
+const quality_bin &inventory::get_quality_index() const
+{
+    if( qualities_indexed ) {
+        return quality_index;
+    }
+
+    quality_index.clear();
+    for( const auto &stack : items ) {
+        const int stack_size = stack.size();
+        stack.front().visit_items( [this, stack_size]( const item * e ) {
+            // An item also has the qualities of its contents.
+            std::set<quality_id> provided;
+            e->visit_items( [&provided]( const item * node ) {
+                for( const auto &quality : node->type->qualities ) {
+                    provided.insert( quality.first );
+                }
+                return VisitResponse::NEXT;
+            } );
+            for( const quality_id &qual : provided ) {
+                const int level = e->get_quality( qual );
+                if( level != INT_MIN ) {
+                    quality_index[qual][level] += stack_size * e->count();
+                }
+            }
+            return VisitResponse::NEXT;
+        } );
+    }
+
+    qualities_indexed = true;
+    return quality_index;
+}
+
 void inventory::copy_invlet_of( const inventory &other )
 {
     assigned_invlet = other.assigned_invlet;
@@ -34,6 +34,8 @@ using invslice = std::vector<std::list<item> *>;
 using const_invslice = std::vector<const std::list<item> *>;
 using indexed_invslice = std::vector< std::pair<std::list<item>*, int> >;
 using itype_bin = std::unordered_map< itype_id, std::list<const item *> >;
+/** For each quality: how many items provide it at each level. */
+using quality_bin = std::map<quality_id, std::map<int, int>>;
 using invlets_bitset = std::bitset<std::numeric_limits<char>::max()>;
 
 /**
@@ -219,6 +221,11 @@ class inventory : public visitable<inventory>
          * May not contain items that wouldn't be visited by @ref visitable methods.
          */
         const itype_bin &get_binned_items() const;
+        /**
+         * Returns how many items provide each level of each quality, counted the way
+         * @ref visitable::has_quality counts them.
+         */
+        const quality_bin &get_quality_index() const;
 
         void update_cache_with_item( item &newit );
 
@@ -233,13 +240,16 @@ class inventory : public visitable<inventory>
 
         invstack items;
 
-        mutable bool binned;
+        mutable bool binned = false;
         /**
          * Items binned by their type.
          * That is, item_bin["carrot"] is a list of pointers to all carrots in inventory.
          * `mutable` because this is a pure cache that doesn't affect the contained items.
          */
         mutable itype_bin binned_items;
+        /** Built together with and invalidated along with @ref binned_items, but on its own. */
+        mutable bool qualities_indexed = false;
+        mutable quality_bin quality_index;
 };
 
 #endif
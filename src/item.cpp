@@ -7806,6 +7806,27 @@ void item::apply_freezerburn()
     }
 }
 
+/** Applies the limits of fridges, freezers etc. to the enviroment temperature */
+static double clamp_to_storage_temperature( double env_temperature, const temperature_flag flag )
+{
+    switch( flag ) {
+        case TEMP_NORMAL:
+            // Just use the temperature normally
+            break;
+        case TEMP_FRIDGE:
+            return std::min( env_temperature, static_cast<double>( temperatures::fridge ) );
+        case TEMP_FREEZER:
+            return std::min( env_temperature, static_cast<double>( temperatures::freezer ) );
+        case TEMP_HEATER:
+            return std::max( env_temperature, static_cast<double>( temperatures::normal ) );
+        case TEMP_ROOT_CELLAR:
+            return AVERAGE_ANNUAL_TEMPERATURE;
+        default:
+            debugmsg( "Temperature flag enum not valid. Using normal temperature." );
+    }
+    return env_temperature;
+}
+
 void item::process_temperature_rot( float insulation, const tripoint &pos,
                                     player *carrier, const temperature_flag flag )
 {
@@ -7866,8 +7887,6 @@ void item::process_temperature_rot( float insulation, const tripoint &pos,
     if( now - time > 1_hours ) {
         // This code is for items that were left out of reality bubble for long time
 
-        const weather_generator &wgen = g->weather.get_cur_weather_gen();
-        const unsigned int seed = g->get_seed();
         const tripoint &local = g->m.getlocal( pos );
         int local_mod = g->new_game ? 0 : g->m.get_temperature( local );
 
@@ -7884,40 +7903,43 @@ void item::process_temperature_rot( float insulation, const tripoint &pos,
             local_mod += 5; // body heat increases inventory temperature
         }
 
-        // Process the past of this item since the last time it was processed
-        while( time < now - 1_hours ) {
-            // Get the enviroment temperature
-            time_duration time_delta = std::min( 1_hours, now - 1_hours - time );
-            time += time_delta;
-
-            //Use weather if above ground, use map temp if below
-            double env_temperature = 0;
-            if( pos.z >= 0 ) {
-                double weather_temperature = wgen.get_weather_temperature( pos, time, seed );
-                env_temperature = weather_temperature + enviroment_mod + local_mod;
-            } else {
-                env_temperature = AVERAGE_ANNUAL_TEMPERATURE + enviroment_mod + local_mod;
+        // Underground and in root cellars the environment does not follow the weather,
+        // so the whole period can be handled in one step
+        if( pos.z < 0 || flag == TEMP_ROOT_CELLAR ) {
+            const double env_temperature = clamp_to_storage_temperature( AVERAGE_ANNUAL_TEMPERATURE +
+                                           enviroment_mod + local_mod, flag );
+            const time_point end = now - 1_hours;
+
+            // Anything older than 2 d has reached the enviroment temperature anyway
+            if( now - last_temp_check > 2_days ) {
+                temperature = static_cast<int>( 100000 * temp_to_kelvin( env_temperature ) );
+                last_temp_check = now - 2_days;
             }
+            if( end - last_temp_check > smallest_interval ) {
+                calc_temp( env_temperature, insulation, end );
+            }
+            if( end - last_rot_check > smallest_interval ) {
+                calc_rot( end, env_temperature );
 
-            switch( flag ) {
-                case TEMP_NORMAL:
-                    // Just use the temperature normally
-                    break;
-                case TEMP_FRIDGE:
-                    env_temperature = std::min( env_temperature, static_cast<double>( temperatures::fridge ) );
-                    break;
-                case TEMP_FREEZER:
-                    env_temperature = std::min( env_temperature, static_cast<double>( temperatures::freezer ) );
-                    break;
-                case TEMP_HEATER:
-                    env_temperature = std::max( env_temperature, static_cast<double>( temperatures::normal ) );
-                    break;
-                case TEMP_ROOT_CELLAR:
-                    env_temperature = AVERAGE_ANNUAL_TEMPERATURE;
-                    break;
-                default:
-                    debugmsg( "Temperature flag enum not valid. Using normal temperature." );
+                if( has_rotten_away() || ( is_corpse() && rot > 10_days ) ) {
+                    // No need to track item that will be gone
+                    item_internal::goes_bad_cache_unset();
+                    return;
+                }
             }
+            time = end;
+        }
+
+        // Process the past of this item since the last time it was processed
+        while( time < now - 1_hours ) {
+            // Step on full hours so the weather sample is shared with the other items nearby
+            const time_point next_hour = time - ( time - calendar::turn_zero ) % 1_hours + 1_hours;
+            time = std::min( next_hour, now - 1_hours );
+
+            // Get the enviroment temperature
+            const double weather_temperature = g->weather.get_catchup_temperature( pos, time );
+            const double env_temperature = clamp_to_storage_temperature( weather_temperature +
+                                           enviroment_mod + local_mod, flag );
 
             // Calculate item temperature from enviroment temperature
             // If the time was more than 2 d ago just set the item to enviroment temperature
@@ -75,25 +75,36 @@ static std::string utf16_to_utf8( uint32_t ch )
  * represents a JSON object,
  * providing access to the underlying data.
  */
-JsonObject::JsonObject( JsonIn &j )
+JsonObject::member_index JsonObject::index_members( JsonIn &jsin )
 {
-    jsin = &j;
-    start = jsin->tell();
+    member_index index;
+    index.start = jsin.tell();
     // cache the position of the value for each member
-    jsin->start_object();
-    while( !jsin->end_object() ) {
-        std::string n = jsin->get_member_name();
-        int p = jsin->tell();
-        if( n != "//" && n != "comment" && positions.count( n ) > 0 ) {
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        std::string n = jsin.get_member_name();
+        int p = jsin.tell();
+        if( n != "//" && n != "comment" && index.positions.count( n ) > 0 ) {
             // members with name "//" or "comment" are used for comments and
             // should be ignored anyway.
-            j.error( "duplicate entry in json object" );
+            jsin.error( "duplicate entry in json object" );
         }
-        positions[n] = p;
-        jsin->skip_value();
+        index.positions[std::move( n )] = p;
+        jsin.skip_value();
     }
-    end = jsin->tell();
-    final_separator = jsin->get_ate_separator();
+    index.end = jsin.tell();
+    index.final_separator = jsin.get_ate_separator();
+    return index;
+}
+
+JsonObject::JsonObject( JsonIn &j ) : JsonObject( j, index_members( j ) )
+{
+}
+
+JsonObject::JsonObject( JsonIn &j, member_index &&index ) :
+    positions( std::move( index.positions ) ), start( index.start ), end( index.end ),
+    final_separator( index.final_separator ), jsin( &j )
+{
 }
 
 void JsonObject::finish()
@@ -687,37 +698,163 @@ void add_array_to_set( std::set<std::string> &s, JsonObject &json, const std::st
     }
 }
 
+JsonIn::JsonIn( const char *data, size_t size ) :
+    buffer_begin( data ), buffer_end( data + size ), buffer_pos( data )
+{
+}
+
+bool JsonIn::get_char( char &ch )
+{
+    if( stream ) {
+        if( stream->get( ch ) ) {
+            return true;
+        }
+    } else if( buffer_pos != buffer_end ) {
+        ch = *buffer_pos++;
+        return true;
+    } else {
+        buffer_eof = true;
+    }
+    // Set ch anyway, so loops looking for some character can't get stuck and errors don't
+    // show whatever ch was before.
+    ch = '\0';
+    return false;
+}
+
+int JsonIn::get_char()
+{
+    if( stream ) {
+        return stream->get();
+    }
+    if( buffer_pos == buffer_end ) {
+        buffer_eof = true;
+        return EOF;
+    }
+    return static_cast<unsigned char>( *buffer_pos++ );
+}
+
+void JsonIn::unget_char()
+{
+    if( stream ) {
+        stream->unget();
+    } else if( !buffer_eof && buffer_pos != buffer_begin ) {
+        --buffer_pos;
+    }
+}
+
+void JsonIn::get_chars( char *text, const int count )
+{
+    if( stream ) {
+        stream->get( text, count );
+        return;
+    }
+    int i = 0;
+    for( ; i < count - 1 && buffer_pos != buffer_end && *buffer_pos != '\n'; i++ ) {
+        text[i] = *buffer_pos++;
+    }
+    text[i] = '\0';
+    if( i < count - 1 && buffer_pos == buffer_end ) {
+        buffer_eof = true;
+    }
+}
+
+void JsonIn::read_chars( char *text, const size_t count )
+{
+    if( stream ) {
+        stream->read( text, count );
+        return;
+    }
+    const size_t available = std::min<size_t>( count, buffer_end - buffer_pos );
+    std::copy( buffer_pos, buffer_pos + available, text );
+    buffer_pos += available;
+    if( available < count ) {
+        buffer_eof = true;
+    }
+}
+
+void JsonIn::seek_relative( const int offset )
+{
+    if( stream ) {
+        stream->seekg( offset, std::istream::cur );
+        return;
+    }
+    buffer_eof = false;
+    if( offset < buffer_begin - buffer_pos ) {
+        buffer_pos = buffer_begin;
+    } else if( offset > buffer_end - buffer_pos ) {
+        buffer_pos = buffer_end;
+    } else {
+        buffer_pos += offset;
+    }
+}
+
+bool JsonIn::at_eof() const
+{
+    return stream ? stream->eof() : buffer_eof;
+}
+
+bool JsonIn::failed() const
+{
+    // Reading past the end of a buffer is reported as eof only.
+    return stream && stream->fail();
+}
+
 int JsonIn::tell()
 {
-    return stream->tellg();
+    if( stream ) {
+        return stream->tellg();
+    }
+    return buffer_pos - buffer_begin;
 }
 char JsonIn::peek()
 {
-    return static_cast<char>( stream->peek() );
+    if( stream ) {
+        return static_cast<char>( stream->peek() );
+    }
+    if( buffer_pos == buffer_end ) {
+        buffer_eof = true;
+        return static_cast<char>( EOF );
+    }
+    return *buffer_pos;
 }
 bool JsonIn::good()
 {
-    return stream->good();
+    return stream ? stream->good() : !buffer_eof;
 }
 
 void JsonIn::seek( int pos )
 {
-    stream->clear();
-    stream->seekg( pos );
+    if( stream ) {
+        stream->clear();
+        stream->seekg( pos );
+    } else {
+        buffer_eof = false;
+        buffer_pos = buffer_begin + clamp<int>( pos, 0, buffer_end - buffer_begin );
+    }
     ate_separator = false;
 }
 
 void JsonIn::eat_whitespace()
 {
+    if( !stream ) {
+        while( buffer_pos != buffer_end && is_whitespace( *buffer_pos ) ) {
+            ++buffer_pos;
+        }
+        if( buffer_pos == buffer_end ) {
+            // As peeking at the end of a stream would.
+            buffer_eof = true;
+        }
+        return;
+    }
     while( is_whitespace( peek() ) ) {
-        stream->get();
+        get_char();
     }
 }
 
 void JsonIn::uneat_whitespace()
 {
     while( tell() > 0 ) {
-        stream->seekg( -1, std::istream::cur );
+        seek_relative( -1 );
         if( !is_whitespace( peek() ) ) {
             break;
         }
@@ -745,7 +882,7 @@ void JsonIn::skip_separator()
         if( ate_separator ) {
             error( "duplicate separator" );
         }
-        stream->get();
+        get_char();
         ate_separator = true;
     } else if( ch == ']' || ch == '}' || ch == ':' ) {
         // okay
@@ -774,7 +911,7 @@ void JsonIn::skip_pair_separator()
 {
     char ch;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch != ':' ) {
         std::stringstream err;
         err << "expected pair separator ':', not '" << ch << "'";
@@ -789,16 +926,16 @@ void JsonIn::skip_string()
 {
     char ch;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch != '"' ) {
         std::stringstream err;
         err << "expecting string but found '" << ch << "'";
         error( err.str(), -1 );
     }
-    while( stream->good() ) {
-        stream->get( ch );
+    while( good() ) {
+        get_char( ch );
         if( ch == '\\' ) {
-            stream->get( ch );
+            get_char( ch );
             continue;
         } else if( ch == '"' ) {
             break;
@@ -863,7 +1000,7 @@ void JsonIn::skip_true()
 {
     char text[5];
     eat_whitespace();
-    stream->get( text, 5 );
+    get_chars( text, 5 );
     if( strcmp( text, "true" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "true", but found ")" << text << "\"";
@@ -876,7 +1013,7 @@ void JsonIn::skip_false()
 {
     char text[6];
     eat_whitespace();
-    stream->get( text, 6 );
+    get_chars( text, 6 );
     if( strcmp( text, "false" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "false", but found ")" << text << "\"";
@@ -889,7 +1026,7 @@ void JsonIn::skip_null()
 {
     char text[5];
     eat_whitespace();
-    stream->get( text, 5 );
+    get_chars( text, 5 );
     if( strcmp( text, "null" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "null", but found ")" << text << "\"";
@@ -903,11 +1040,11 @@ void JsonIn::skip_number()
     char ch;
     eat_whitespace();
     // skip all of (+-0123456789.eE)
-    while( stream->good() ) {
-        stream->get( ch );
+    while( good() ) {
+        get_char( ch );
         if( ch != '+' && ch != '-' && ( ch < '0' || ch > '9' ) &&
             ch != 'e' && ch != 'E' && ch != '.' ) {
-            stream->unget();
+            unget_char();
             break;
         }
     }
@@ -930,16 +1067,28 @@ std::string JsonIn::get_string()
     eat_whitespace();
     int startpos = tell();
     // the first character had better be a '"'
-    stream->get( ch );
+    get_char( ch );
     if( ch != '"' ) {
         std::stringstream err;
         err << "expecting string but got '" << ch << "'";
         error( err.str(), -1 );
     }
+    if( !stream ) {
+        // Copy everything up to the first character that needs a closer look at once,
+        // for most strings that is the closing quote.
+        const char *run = buffer_pos;
+        while( buffer_pos != buffer_end && *buffer_pos != '"' && *buffer_pos != '\\' &&
+               static_cast<unsigned char>( *buffer_pos ) >= 0x20 ) {
+            ++buffer_pos;
+        }
+        s.assign( run, buffer_pos );
+    }
     // add chars to the string, one at a time, converting:
     // \", \\, \/, \b, \f, \n, \r, \t and \uxxxx according to JSON spec.
-    while( stream->good() ) {
-        stream->get( ch );
+    while( good() ) {
+        if( !get_char( ch ) ) {
+            break;
+        }
         if( ch == '\\' ) {
             if( backslash ) {
                 s += '\\';
@@ -966,7 +1115,7 @@ std::string JsonIn::get_string()
                 s += '\t';
             } else if( ch == 'u' ) {
                 // get the next four characters as hexadecimal
-                stream->get( unihex, 5 );
+                get_chars( unihex, 5 );
                 // insert the appropriate unicode character in utf8
                 // TODO: verify that unihex is in fact 4 hex digits.
                 char **endptr = nullptr;
@@ -993,11 +1142,10 @@ std::string JsonIn::get_string()
         }
     }
     // if we get to here, probably hit a premature EOF?
-    if( stream->eof() ) {
-        stream->clear();
+    if( at_eof() ) {
         seek( startpos );
         error( "couldn't find end of string, reached EOF." );
-    } else if( stream->fail() ) {
+    } else if( failed() ) {
         throw JsonError( "stream failure while reading string." );
     }
     throw JsonError( "something went wrong D:" );
@@ -1026,10 +1174,10 @@ double JsonIn::get_float()
     int e = 0;
     int mod_e = 0;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch == '-' ) {
         neg = true;
-        stream->get( ch );
+        get_char( ch );
     } else if( ch != '.' && ( ch < '0' || ch > '9' ) ) {
         // not a valid float
         std::stringstream err;
@@ -1038,7 +1186,7 @@ double JsonIn::get_float()
     }
     if( ch == '0' ) {
         // allow a single leading zero in front of a '.' or 'e'/'E'
-        stream->get( ch );
+        get_char( ch );
         if( ch >= '0' && ch <= '9' ) {
             error( "leading zeros not strictly allowed", -1 );
         }
@@ -1046,40 +1194,40 @@ double JsonIn::get_float()
     while( ch >= '0' && ch <= '9' ) {
         i *= 10;
         i += ( ch - '0' );
-        stream->get( ch );
+        get_char( ch );
     }
     if( ch == '.' ) {
-        stream->get( ch );
+        get_char( ch );
         while( ch >= '0' && ch <= '9' ) {
             i *= 10;
             i += ( ch - '0' );
             mod_e -= 1;
-            stream->get( ch );
+            get_char( ch );
         }
     }
     if( neg ) {
         i *= -1;
     }
     if( ch == 'e' || ch == 'E' ) {
-        stream->get( ch );
+        get_char( ch );
         neg = false;
         if( ch == '-' ) {
             neg = true;
-            stream->get( ch );
+            get_char( ch );
         } else if( ch == '+' ) {
-            stream->get( ch );
+            get_char( ch );
         }
         while( ch >= '0' && ch <= '9' ) {
             e *= 10;
             e += ( ch - '0' );
-            stream->get( ch );
+            get_char( ch );
         }
         if( neg ) {
             e *= -1;
         }
     }
     // unget the final non-number character (probably a separator)
-    stream->unget();
+    unget_char();
     end_value();
     // now put it all together!
     return i * std::pow( 10.0f, e + mod_e );
@@ -1091,9 +1239,9 @@ bool JsonIn::get_bool()
     char text[5];
     std::stringstream err;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch == 't' ) {
-        stream->get( text, 4 );
+        get_chars( text, 4 );
         if( strcmp( text, "rue" ) == 0 ) {
             end_value();
             return true;
@@ -1103,7 +1251,7 @@ bool JsonIn::get_bool()
             error( err.str(), -4 );
         }
     } else if( ch == 'f' ) {
-        stream->get( text, 5 );
+        get_chars( text, 5 );
         if( strcmp( text, "alse" ) == 0 ) {
             end_value();
             return false;
@@ -1131,7 +1279,7 @@ void JsonIn::start_array()
 {
     eat_whitespace();
     if( peek() == '[' ) {
-        stream->get();
+        get_char();
         ate_separator = false;
         return;
     } else {
@@ -1151,7 +1299,7 @@ bool JsonIn::end_array()
             uneat_whitespace();
             error( "separator not strictly allowed at end of array" );
         }
-        stream->get();
+        get_char();
         end_value();
         return true;
     } else {
@@ -1164,7 +1312,7 @@ void JsonIn::start_object()
 {
     eat_whitespace();
     if( peek() == '{' ) {
-        stream->get();
+        get_char();
         ate_separator = false; // not that we want to
         return;
     } else {
@@ -1184,7 +1332,7 @@ bool JsonIn::end_object()
             uneat_whitespace();
             error( "separator not strictly allowed at end of object" );
         }
-        stream->get();
+        get_char();
         end_value();
         return true;
     } else {
@@ -1387,11 +1535,12 @@ bool JsonIn::read( JsonDeserializer &j, bool throw_on_error )
 // WARNING: for occasional use only.
 std::string JsonIn::line_number( int offset_modifier )
 {
-    if( !stream || stream->fail() ) {
-        return "???";
-    }
-    if( stream->eof() ) {
+    // Reading past the end fails a stream too, that is still the end.
+    if( at_eof() ) {
         return "EOF";
+    }
+    if( failed() ) {
+        return "???";
     } // else stream is fine
     int pos = tell();
     int line = 1;
@@ -1399,12 +1548,12 @@ std::string JsonIn::line_number( int offset_modifier )
     char ch;
     seek( 0 );
     for( int i = 0; i < pos; ++i ) {
-        stream->get( ch );
+        get_char( ch );
         if( ch == '\r' ) {
             offset = 1;
             ++line;
             if( peek() == '\n' ) {
-                stream->get();
+                get_char();
                 ++i;
             }
         } else if( ch == '\n' ) {
@@ -1424,17 +1573,17 @@ void JsonIn::error( const std::string &message, int offset )
     std::ostringstream err;
     err << line_number( offset ) << ": " << message;
     // if we can't get more info from the stream don't try
-    if( !stream->good() ) {
+    if( !good() ) {
         throw JsonError( err.str() );
     }
     // also print surrounding few lines of context, if not too large
     err << "\n\n";
-    stream->seekg( offset, std::istream::cur );
+    seek_relative( offset );
     size_t pos = tell();
     rewind( 3, 240 );
     size_t startpos = tell();
     std::string buffer( pos - startpos, '\0' );
-    stream->read( &buffer[0], pos - startpos );
+    read_chars( &buffer[0], pos - startpos );
     err << buffer;
     if( !is_whitespace( peek() ) ) {
         err << peek();
@@ -1449,10 +1598,10 @@ void JsonIn::error( const std::string &message, int offset )
     err << "^\n";
     seek( pos );
     // if that wasn't the end of the line, continue underneath pointer
-    char ch = stream->get();
+    char ch = get_char();
     if( ch == '\r' ) {
         if( peek() == '\n' ) {
-            stream->get();
+            get_char();
         }
     } else if( ch == '\n' ) {
         // pass
@@ -1464,12 +1613,14 @@ void JsonIn::error( const std::string &message, int offset )
     // print the next couple lines as well
     int line_count = 0;
     for( int i = 0; i < 240; ++i ) {
-        stream->get( ch );
+        if( !get_char( ch ) ) {
+            break;
+        }
         err << ch;
         if( ch == '\r' ) {
             ++line_count;
             if( peek() == '\n' ) {
-                err << stream->get();
+                err << get_char();
             }
         } else if( ch == '\n' ) {
             ++line_count;
@@ -1500,13 +1651,13 @@ void JsonIn::rewind( int max_lines, int max_chars )
         return;
     }
     int lines_found = 0;
-    stream->seekg( -1, std::istream::cur );
+    seek_relative( -1 );
     for( int i = 0; i < max_chars; ++i ) {
         size_t tellpos = tell();
         if( peek() == '\n' ) {
             ++lines_found;
             if( tellpos > 0 ) {
-                stream->seekg( -1, std::istream::cur );
+                seek_relative( -1 );
                 // note: does not update tellpos or count a character
                 if( peek() != '\r' ) {
                     continue;
@@ -1519,10 +1670,10 @@ void JsonIn::rewind( int max_lines, int max_chars )
             break;
         } else if( lines_found == max_lines ) {
             // don't include the last \n or \r
-            stream->seekg( 1, std::istream::cur );
+            seek_relative( 1 );
             break;
         }
-        stream->seekg( -1, std::istream::cur );
+        seek_relative( -1 );
     }
 }
 
@@ -1530,13 +1681,20 @@ std::string JsonIn::substr( size_t pos, size_t len )
 {
     std::string ret;
     if( len == std::string::npos ) {
-        stream->seekg( 0, std::istream::end );
-        size_t end = tell();
-        len = end - pos;
+        if( stream ) {
+            stream->seekg( 0, std::istream::end );
+            len = tell() - pos;
+        } else {
+            len = buffer_end - buffer_begin - pos;
+        }
     }
     ret.resize( len );
-    stream->seekg( pos );
-    stream->read( &ret[0], len );
+    if( stream ) {
+        stream->seekg( pos );
+    } else {
+        buffer_pos = buffer_begin + std::min<size_t>( pos, buffer_end - buffer_begin );
+    }
+    read_chars( &ret[0], len );
     return ret;
 }
 
@@ -155,15 +155,42 @@ struct key_from_json_string<Enum, std::enable_if_t<std::is_enum<Enum>::value>> {
 class JsonIn
 {
     private:
-        std::istream *stream;
+        std::istream *stream = nullptr;
+        /**
+         * Input of the buffer constructor, used instead of @ref stream. Reading from it skips
+         * the sentry and locale work a stream does for every character.
+         */
+        const char *buffer_begin = nullptr;
+        const char *buffer_end = nullptr;
+        const char *buffer_pos = nullptr;
+        /** Set by reading past the end of the buffer, like the eof state of a stream. */
+        bool buffer_eof = false;
         bool ate_separator = false;
 
         void skip_separator();
         void skip_pair_separator();
         void end_value();
 
+        // Access to the input, with the semantics of the std::istream function of the same
+        // name, no matter whether the input is a stream or a buffer.
+        bool get_char( char &ch );
+        int get_char();
+        void unget_char();
+        void get_chars( char *text, int count );
+        void read_chars( char *text, size_t count );
+        void seek_relative( int offset );
+        bool at_eof() const;
+        bool failed() const;
+
     public:
         JsonIn( std::istream &s ) : stream( &s ) {}
+        /**
+         * Reads from the @p size bytes at @p data, which must stay valid (and unchanged) as
+         * long as this and any JsonObject or JsonArray from it are in use.
+         */
+        JsonIn( const char *data, size_t size );
+        explicit JsonIn( const std::string &data ) : JsonIn( data.data(), data.size() ) {}
+        JsonIn( std::string && ) = delete;
         JsonIn( const JsonIn & ) = delete;
         JsonIn &operator=( const JsonIn & ) = delete;
 
@@ -789,7 +816,23 @@ class JsonObject
                              bool throw_exception = true );
 
     public:
+        /** Where the members of an object are, see @ref index_members. */
+        struct member_index {
+            std::map<std::string, int> positions;
+            int start = 0;
+            int end = 0;
+            bool final_separator = false;
+        };
+        /**
+         * Finds the members of the object at the current position of @p jsin, as the
+         * constructor does, and moves past the object. Only touches @p jsin, so it may run
+         * on another thread than the one using the index later.
+         */
+        static member_index index_members( JsonIn &jsin );
+
         JsonObject( JsonIn &jsin );
+        /** The object found by @ref index_members in the same, unchanged, input. */
+        JsonObject( JsonIn &jsin, member_index &&index );
         JsonObject() : start( 0 ), end( 0 ), jsin( nullptr ) {}
         JsonObject( const JsonObject & ) = default;
         JsonObject( JsonObject && ) = default;
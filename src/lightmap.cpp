@@ -1,6 +1,7 @@
 #include "lightmap.h" // IWYU pragma: associated
 #include "shadowcasting.h" // IWYU pragma: associated
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <cmath>
@@ -32,6 +33,7 @@
 #include "optional.h"
 #include "player.h"
 #include "string_formatter.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "type_id.h"
 #include "colony.h"
@@ -80,71 +82,117 @@ bool map::build_transparency_cache( const int zlev )
     auto &transparency_cache = map_cache.transparency_cache;
     auto &outside_cache = map_cache.outside_cache;
 
-    if( !map_cache.transparency_cache_dirty ) {
+    if( !map_cache.transparency_cache_dirty && map_cache.transparency_dirty_submaps.none() ) {
         return false;
     }
 
-    // Default to just barely not transparent.
-    std::uninitialized_fill_n(
-        &transparency_cache[0][0], MAPSIZE_X * MAPSIZE_Y,
-        static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR ) );
-
     const float sight_penalty = weather::sight_penalty( g->weather.weather );
 
-    // Traverse the submaps in order
-    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
-        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            const auto cur_submap = get_submap_at_grid( {smx, smy, zlev} );
+    const auto build_submap = [&]( const int smx, const int smy ) {
+        const auto cur_submap = get_submap_at_grid( {smx, smy, zlev} );
 
-            float zero_value = LIGHT_TRANSPARENCY_OPEN_AIR;
-            for( int sx = 0; sx < SEEX; ++sx ) {
-                for( int sy = 0; sy < SEEY; ++sy ) {
-                    const int x = sx + smx * SEEX;
-                    const int y = sy + smy * SEEY;
+        float zero_value = LIGHT_TRANSPARENCY_OPEN_AIR;
+        for( int sx = 0; sx < SEEX; ++sx ) {
+            for( int sy = 0; sy < SEEY; ++sy ) {
+                const int x = sx + smx * SEEX;
+                const int y = sy + smy * SEEY;
 
-                    float &value = transparency_cache[x][y];
-                    if( cur_submap->is_uniform && sx + sy > 0 ) {
-                        value = zero_value;
-                        continue;
-                    }
+                float &value = transparency_cache[x][y];
+                if( cur_submap->is_uniform && sx + sy > 0 ) {
+                    value = zero_value;
+                    continue;
+                }
 
-                    if( !( cur_submap->ter[sx][sy].obj().transparent &&
-                           cur_submap->frn[sx][sy].obj().transparent ) ) {
-                        value = LIGHT_TRANSPARENCY_SOLID;
-                        zero_value = LIGHT_TRANSPARENCY_SOLID;
-                        continue;
-                    }
+                if( !( cur_submap->ter[sx][sy].obj().transparent &&
+                       cur_submap->frn[sx][sy].obj().transparent ) ) {
+                    value = LIGHT_TRANSPARENCY_SOLID;
+                    zero_value = LIGHT_TRANSPARENCY_SOLID;
+                    continue;
+                }
 
-                    if( outside_cache[x][y] ) {
-                        // FIXME: Places inside vehicles haven't been marked as
-                        // inside yet so this is incorrectly penalising for
-                        // weather in vehicles.
-                        value *= sight_penalty;
+                if( outside_cache[x][y] ) {
+                    // FIXME: Places inside vehicles haven't been marked as
+                    // inside yet so this is incorrectly penalising for
+                    // weather in vehicles.
+                    value *= sight_penalty;
+                }
+                if( cur_submap->is_uniform ) {
+                    if( value == LIGHT_TRANSPARENCY_OPEN_AIR ) {
+                        break;
                     }
-                    if( cur_submap->is_uniform ) {
-                        if( value == LIGHT_TRANSPARENCY_OPEN_AIR ) {
-                            break;
-                        }
-                        zero_value = value;
+                    zero_value = value;
+                    continue;
+                }
+                for( const auto &fld : cur_submap->fld.peek( { sx, sy } ) ) {
+                    const field_entry &cur = fld.second;
+                    if( cur.is_transparent() ) {
                         continue;
                     }
-                    for( const auto &fld : cur_submap->fld[sx][sy] ) {
-                        const field_entry &cur = fld.second;
-                        if( cur.is_transparent() ) {
-                            continue;
-                        }
-                        // Fields are either transparent or not, however we want some to be translucent
-                        value = value * cur.translucency();
-                    }
-                    // TODO: [lightmap] Have glass reduce light as well
+                    // Fields are either transparent or not, however we want some to be translucent
+                    value = value * cur.translucency();
+                }
+                // TODO: [lightmap] Have glass reduce light as well
+            }
+        }
+    };
+
+    if( !map_cache.transparency_cache_dirty ) {
+        // Only rebuild the submaps that changed
+        auto &dirty_submaps = map_cache.transparency_dirty_submaps;
+        const bool seen_dirty = any_submap_seen( dirty_submaps, zlev );
+        for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+            for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+                if( !dirty_submaps[smx + smy * MAPSIZE] ) {
+                    continue;
+                }
+                // Default to just barely not transparent.
+                for( int sx = 0; sx < SEEX; ++sx ) {
+                    std::uninitialized_fill_n( &transparency_cache[sx + smx * SEEX][smy * SEEY], SEEY,
+                                               static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR ) );
                 }
+                build_submap( smx, smy );
             }
         }
+        dirty_submaps.reset();
+        return seen_dirty;
+    }
+
+    // Default to just barely not transparent.
+    std::uninitialized_fill_n(
+        &transparency_cache[0][0], MAPSIZE_X * MAPSIZE_Y,
+        static_cast<float>( LIGHT_TRANSPARENCY_OPEN_AIR ) );
+
+    // Traverse the submaps in order
+    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            build_submap( smx, smy );
+        }
     }
     map_cache.transparency_cache_dirty = false;
+    map_cache.transparency_dirty_submaps.reset();
     return true;
 }
 
+bool map::any_submap_seen( const std::bitset<MAPSIZE *MAPSIZE> &submaps, const int zlev ) const
+{
+    const level_cache &map_cache = get_cache_ref( zlev );
+    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !submaps[smx + smy * MAPSIZE] ) {
+                continue;
+            }
+            for( int x = smx * SEEX; x < ( smx + 1 ) * SEEX; ++x ) {
+                for( int y = smy * SEEY; y < ( smy + 1 ) * SEEY; ++y ) {
+                    if( map_cache.seen_cache[x][y] > 0.0f || map_cache.camera_cache[x][y] > 0.0f ) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
 void map::apply_character_light( player &p )
 {
     if( p.has_effect( effect_onfire ) ) {
@@ -333,7 +381,7 @@ void map::generate_lightmap( const int zlev )
                         add_light_source( p, furniture->light_emitted );
                     }
 
-                    for( auto &fld : cur_submap->fld[sx][sy] ) {
+                    for( const auto &fld : cur_submap->fld.peek( { sx, sy } ) ) {
                         const field_entry *cur = &fld.second;
                         const int light_emitted = cur->light_emitted();
                         if( light_emitted > 0 ) {
@@ -440,11 +488,13 @@ void map::generate_lightmap( const int zlev )
     */
     const tripoint cache_start( 0, 0, zlev );
     const tripoint cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
+    std::vector<tripoint> buffered_sources;
     for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
         if( light_source_buffer[p.x][p.y] > 0.0 ) {
-            apply_light_source( p, light_source_buffer[p.x][p.y] );
+            buffered_sources.push_back( p );
         }
     }
+    apply_buffered_light_sources( zlev, buffered_sources );
 
     if( g->u.has_active_bionic( bionic_id( "bio_night" ) ) ) {
         for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
@@ -455,6 +505,50 @@ void map::generate_lightmap( const int zlev )
     }
 }
 
+void map::apply_buffered_light_sources( const int zlev, const std::vector<tripoint> &sources )
+{
+    auto &map_cache = get_cache( zlev );
+    const auto &light_source_buffer = map_cache.light_source_buffer;
+    thread_pool *const workers = get_worker_threads();
+    if( workers == nullptr || sources.size() < 2 ) {
+        for( const tripoint &p : sources ) {
+            apply_light_source( p, light_source_buffer[p.x][p.y] );
+        }
+        return;
+    }
+
+    // Each thread lights its own copy of the map, which are then merged by taking the
+    // brightest value. Lights only ever raise the light level, so the result is the same
+    // as applying them one after another.
+    struct light_buffers {
+        four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+        float sm[MAPSIZE_X][MAPSIZE_Y];
+    };
+    const int parts = std::min( workers->size(), static_cast<int>( sources.size() ) );
+    std::vector<std::unique_ptr<light_buffers>> buffers( parts );
+    workers->run( parts, [&]( const int part ) {
+        buffers[part] = std::make_unique<light_buffers>();
+        light_buffers &buf = *buffers[part];
+        std::fill_n( &buf.lm[0][0], MAPSIZE_X * MAPSIZE_Y, four_quadrants( 0.0f ) );
+        std::fill_n( &buf.sm[0][0], MAPSIZE_X * MAPSIZE_Y, 0.0f );
+        for( size_t i = part; i < sources.size(); i += parts ) {
+            const tripoint &p = sources[i];
+            apply_light_source( p, light_source_buffer[p.x][p.y], buf.lm, buf.sm );
+        }
+    } );
+
+    auto &lm = map_cache.lm;
+    auto &sm = map_cache.sm;
+    for( const std::unique_ptr<light_buffers> &buf : buffers ) {
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                lm[x][y] = elementwise_max( lm[x][y], buf->lm[x][y] );
+                sm[x][y] = std::max( sm[x][y], buf->sm[x][y] );
+            }
+        }
+    }
+}
+
 void map::add_light_source( const tripoint &p, float luminance )
 {
     auto &light_source_buffer = get_cache( p.z ).light_source_buffer;
@@ -1222,10 +1316,16 @@ static bool light_check( const float &transparency, const float &intensity )
 void map::apply_light_source( const tripoint &p, float luminance )
 {
     auto &cache = get_cache( p.z );
-    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
-    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
-    float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
-    float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
+    apply_light_source( p, luminance, cache.lm, cache.sm );
+}
+
+void map::apply_light_source( const tripoint &p, float luminance,
+                              four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                              float ( &sm )[MAPSIZE_X][MAPSIZE_Y] ) const
+{
+    const auto &cache = get_cache_ref( p.z );
+    const float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
+    const float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
 
     const int x = p.x;
     const int y = p.y;
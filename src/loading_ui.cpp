@@ -1,8 +1,10 @@
 #include "loading_ui.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "color.h"
+#include "debug.h"
 #include "output.h"
 #include "ui.h"
 #include "cursesdef.h"
@@ -68,3 +70,28 @@ void loading_ui::show()
 #endif // TILES
     }
 }
+
+void loading_ui::add_timing( const std::string &what, const std::chrono::microseconds duration )
+{
+    timings.emplace_back( what, duration );
+}
+
+void loading_ui::report_timings()
+{
+    if( timings.empty() ) {
+        return;
+    }
+    std::stable_sort( timings.begin(), timings.end(), []( const auto & lhs, const auto & rhs ) {
+        return lhs.second > rhs.second;
+    } );
+    std::chrono::microseconds total( 0 );
+    for( const auto &timing : timings ) {
+        total += timing.second;
+    }
+    DebugLog( D_INFO, DC_ALL ) << "Loading times of " << timings.size() << " files, " <<
+                               total.count() / 1000 << " ms in sum:";
+    for( const auto &timing : timings ) {
+        DebugLog( D_INFO, DC_ALL ) << "  " << timing.second.count() << " us: " << timing.first;
+    }
+    timings.clear();
+}
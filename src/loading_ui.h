@@ -2,9 +2,11 @@
 #ifndef LOADING_UI_H
 #define LOADING_UI_H
 
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <string>
+#include <utility>
 
 class uilist;
 
@@ -13,6 +15,7 @@ class loading_ui
     private:
         std::unique_ptr<uilist> menu;
         std::vector<std::string> entries;
+        std::vector<std::pair<std::string, std::chrono::microseconds>> timings;
     public:
         loading_ui( bool display );
         ~loading_ui();
@@ -33,6 +36,14 @@ class loading_ui
          * Shows the UI on the screen (if display is enabled).
          */
         void show();
+        /**
+         * Records how long loading @p what took, for @ref report_timings.
+         */
+        void add_timing( const std::string &what, std::chrono::microseconds duration );
+        /**
+         * Writes the recorded timings to the debug log, slowest first, and forgets them.
+         */
+        void report_timings();
 };
 
 #endif
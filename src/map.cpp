@@ -55,6 +55,7 @@
 #include "submap.h"
 #include "timed_event.h"
 #include "translations.h"
+#include "thread_pool.h"
 #include "trap.h"
 #include "veh_type.h"
 #include "vehicle.h"
@@ -216,6 +217,7 @@ void map::add_vehicle_to_cache( vehicle *veh )
         return;
     }
 
+    vehicle::invalidate_power_grids();
     auto &ch = get_cache( veh->sm_pos.z );
     ch.veh_in_active_range = true;
     // Get parts
@@ -227,10 +229,10 @@ void map::add_vehicle_to_cache( vehicle *veh )
             continue;
         }
         const tripoint p = veh->global_part_pos3( *it );
-        ch.veh_cached_parts.insert( std::make_pair( p,
-                                    std::make_pair( veh, partid ) ) );
-        if( inbounds( p ) ) {
-            ch.veh_exists_at[p.x][p.y] = true;
+        const auto inserted = ch.veh_cached_parts.insert( std::make_pair( p,
+                              std::make_pair( veh, partid ) ) );
+        if( inserted.second && inbounds( p ) ) {
+            ch.veh_cached_at[p.x][p.y] = inserted.first->second;
         }
     }
 }
@@ -250,7 +252,7 @@ void map::update_vehicle_cache( vehicle *veh, const int old_zlevel )
         if( it->second.first == veh ) {
             const tripoint p = it->first;
             if( inbounds( p ) ) {
-                ch.veh_exists_at[p.x][p.y] = false;
+                ch.veh_cached_at[p.x][p.y] = std::make_pair( nullptr, -1 );
             }
             ch.veh_cached_parts.erase( it++ );
             // If something was resting on vehicle, drop it
@@ -265,12 +267,13 @@ void map::update_vehicle_cache( vehicle *veh, const int old_zlevel )
 
 void map::clear_vehicle_cache( const int zlev )
 {
+    vehicle::invalidate_power_grids();
     auto &ch = get_cache( zlev );
     while( !ch.veh_cached_parts.empty() ) {
         const auto part = ch.veh_cached_parts.begin();
         const auto &p = part->first;
         if( inbounds( p ) ) {
-            ch.veh_exists_at[p.x][p.y] = false;
+            ch.veh_cached_at[p.x][p.y] = std::make_pair( nullptr, -1 );
         }
         ch.veh_cached_parts.erase( part );
     }
@@ -916,20 +919,14 @@ const vehicle *map::veh_at_internal( const tripoint &p, int &part_num ) const
 {
     // This function is called A LOT. Move as much out of here as possible.
     const auto &ch = get_cache_ref( p.z );
-    if( !ch.veh_in_active_range || !ch.veh_exists_at[p.x][p.y] ) {
+    if( !ch.veh_in_active_range ) {
         part_num = -1;
         return nullptr; // Clear cache indicates no vehicle. This should optimize a great deal.
     }
 
-    const auto it = ch.veh_cached_parts.find( p );
-    if( it != ch.veh_cached_parts.end() ) {
-        part_num = it->second.second;
-        return it->second.first;
-    }
-
-    debugmsg( "vehicle part cache indicated vehicle not found: %d %d %d", p.x, p.y, p.z );
-    part_num = -1;
-    return nullptr;
+    const std::pair<vehicle *, int> &cached = ch.veh_cached_at[p.x][p.y];
+    part_num = cached.second;
+    return cached.first;
 }
 
 vehicle *map::veh_at_internal( const tripoint &p, int &part_num )
@@ -1316,20 +1313,20 @@ void map::furn_set( const tripoint &p, const furn_id &new_furniture )
         field_furn_locs.push_back( p );
     }
     if( old_t.transparent != new_t.transparent ) {
-        set_transparency_cache_dirty( p.z );
+        set_transparency_cache_dirty( p );
     }
 
     if( old_t.has_flag( TFLAG_INDOORS ) != new_t.has_flag( TFLAG_INDOORS ) ) {
-        set_outside_cache_dirty( p.z );
+        set_outside_cache_dirty( p );
     }
 
     if( old_t.has_flag( TFLAG_NO_FLOOR ) != new_t.has_flag( TFLAG_NO_FLOOR ) ) {
-        set_floor_cache_dirty( p.z );
+        set_floor_cache_dirty( p );
     }
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     // Make sure the furniture falls if it needs to
     support_dirty( p );
@@ -1590,22 +1587,22 @@ bool map::ter_set( const tripoint &p, const ter_id &new_terrain )
     }
 
     if( old_t.transparent != new_t.transparent ) {
-        set_transparency_cache_dirty( p.z );
+        set_transparency_cache_dirty( p );
     }
 
     if( old_t.has_flag( TFLAG_INDOORS ) != new_t.has_flag( TFLAG_INDOORS ) ) {
-        set_outside_cache_dirty( p.z );
+        set_outside_cache_dirty( p );
     }
 
     if( new_t.has_flag( TFLAG_NO_FLOOR ) != old_t.has_flag( TFLAG_NO_FLOOR ) ) {
-        set_floor_cache_dirty( p.z );
+        set_floor_cache_dirty( p );
         // It's a set, not a flag
         support_cache_dirty.insert( p );
     }
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     tripoint above( p.xy(), p.z + 1 );
     // Make sure that if we supported something and no longer do so, it falls down
@@ -2202,6 +2199,7 @@ void map::drop_fields( const tripoint &p )
     for( const auto &entry : dropped ) {
         fld.remove_field( entry );
     }
+    get_submap_at( p )->emptied_tiles = true;
 }
 
 void map::support_dirty( const tripoint &p )
@@ -2779,7 +2777,11 @@ void map::decay_fields_and_scent( const time_duration &amount )
                     const int x = sx + smx * SEEX;
                     const int y = sy + smy * SEEY;
 
-                    field &fields = cur_submap->fld[sx][sy];
+                    field *const tile_fields = cur_submap->fld.find( { sx, sy } );
+                    if( tile_fields == nullptr ) {
+                        continue;
+                    }
+                    field &fields = *tile_fields;
                     if( !outside_cache[x][y] ) {
                         to_proc -= fields.field_count();
                         continue;
@@ -2877,6 +2879,9 @@ bool map::mop_spills( const tripoint &p )
     for( field_type_id fid : to_check ) {
         retval |= fld.remove_field( fid );
     }
+    if( retval && inbounds( p ) ) {
+        get_submap_at( p )->emptied_tiles = true;
+    }
 
     if( const optional_vpart_position vp = veh_at( p ) ) {
         vehicle *const veh = &vp->vehicle();
@@ -4144,10 +4149,7 @@ map_stack map::i_at( const point &p )
         return map_stack{ &nulitems, tripoint( p, abs_sub.z ), this };
     }
 
-    point l;
-    submap *const current_submap = get_submap_at( p, l );
-
-    return map_stack{ &current_submap->itm[l.x][l.y], tripoint( p, abs_sub.z ), this };
+    return i_at( tripoint( p, abs_sub.z ) );
 }
 
 map_stack::iterator map::i_rem( const point &location, map_stack::const_iterator it )
@@ -4206,7 +4208,12 @@ map_stack map::i_at( const tripoint &p )
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
-    return map_stack{ &current_submap->itm[l.x][l.y], p, this };
+    if( current_submap->itm.find( l ) == nullptr ) {
+        // The caller may add items through the stack it holds, so the tile gets storage now.
+        // It is released again at the end of the turn if it stays empty.
+        current_submap->emptied_tiles = true;
+    }
+    return map_stack{ &current_submap->itm.get( l ), p, this };
 }
 
 map_stack::iterator map::i_rem( const tripoint &p, map_stack::const_iterator it )
@@ -4221,8 +4228,9 @@ map_stack::iterator map::i_rem( const tripoint &p, map_stack::const_iterator it
     }
 
     current_submap->update_lum_rem( l, *it );
+    current_submap->emptied_tiles = true;
 
-    return current_submap->itm[l.x][l.y].erase( it );
+    return current_submap->itm.get( l ).erase( it );
 }
 
 void map::i_rem( const tripoint &p, item *it )
@@ -4239,16 +4247,20 @@ void map::i_clear( const tripoint &p )
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
-    for( item &it : current_submap->itm[l.x][l.y] ) {
-        // remove from the active items cache (if it isn't there does nothing)
-        current_submap->active_items.remove( &it );
+    cata::colony<item> *const items = current_submap->itm.find( l );
+    if( items != nullptr ) {
+        for( item &it : *items ) {
+            // remove from the active items cache (if it isn't there does nothing)
+            current_submap->active_items.remove( &it );
+        }
+        items->clear();
+        current_submap->emptied_tiles = true;
     }
     if( current_submap->active_items.empty() ) {
         submaps_with_active_items.erase( tripoint( abs_sub.x + p.x / SEEX, abs_sub.y + p.y / SEEY, p.z ) );
     }
 
     current_submap->lum[l.x][l.y] = 0;
-    current_submap->itm[l.x][l.y].clear();
 }
 
 item &map::spawn_an_item( const tripoint &p, item new_item,
@@ -4476,7 +4488,7 @@ item &map::add_item( const tripoint &p, item new_item )
     current_submap->is_uniform = false;
     current_submap->update_lum_add( l, new_item );
 
-    const map_stack::iterator new_pos = current_submap->itm[l.x][l.y].insert( new_item );
+    const map_stack::iterator new_pos = current_submap->itm.get( l ).insert( new_item );
     if( new_item.needs_processing() ) {
         if( current_submap->active_items.empty() ) {
             submaps_with_active_items.insert( tripoint( abs_sub.x + p.x / SEEX, abs_sub.y + p.y / SEEY, p.z ) );
@@ -4538,7 +4550,7 @@ void map::make_active( item_location &loc )
     }
     point l;
     submap *const current_submap = get_submap_at( loc.position(), l );
-    cata::colony<item> &item_stack = current_submap->itm[l.x][l.y];
+    cata::colony<item> &item_stack = current_submap->itm.get( l );
     cata::colony<item>::iterator iter = item_stack.get_iterator_from_pointer( target );
 
     if( current_submap->active_items.empty() ) {
@@ -4681,6 +4693,22 @@ void map::process_active_items()
     process_items( true, process_map_items, std::string {} );
 }
 
+void map::release_empty_tiles()
+{
+    const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
+    const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+    for( int gz = minz; gz <= maxz; ++gz ) {
+        for( int gx = 0; gx < my_MAPSIZE; ++gx ) {
+            for( int gy = 0; gy < my_MAPSIZE; ++gy ) {
+                submap *const current_submap = get_submap_at_grid( { gx, gy, gz } );
+                if( current_submap != nullptr && current_submap->emptied_tiles ) {
+                    current_submap->release_empty_tiles();
+                }
+            }
+        }
+    }
+}
+
 void map::process_items( const bool active, map::map_process_func processor,
                          const std::string &signal )
 {
@@ -4877,7 +4905,7 @@ bool map::has_items( const tripoint &p ) const
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
-    return !current_submap->itm[l.x][l.y].empty();
+    return !current_submap->itm.peek( l ).empty();
 }
 
 template <typename Stack>
@@ -5388,7 +5416,7 @@ const field &map::field_at( const tripoint &p ) const
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
-    return current_submap->fld[l.x][l.y];
+    return current_submap->fld.peek( l );
 }
 
 /*
@@ -5404,7 +5432,11 @@ field &map::field_at( const tripoint &p )
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
-    return current_submap->fld[l.x][l.y];
+    if( current_submap->fld.find( l ) == nullptr ) {
+        // See i_at, the caller may change the field it holds.
+        current_submap->emptied_tiles = true;
+    }
+    return current_submap->fld.get( l );
 }
 
 time_duration map::mod_field_age( const tripoint &p, const field_type_id type,
@@ -5472,7 +5504,8 @@ field_entry *map::get_field( const tripoint &p, const field_type_id type )
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
-    return current_submap->fld[l.x][l.y].find_field( type );
+    field *const fields = current_submap->fld.find( l );
+    return fields != nullptr ? fields->find_field( type ) : nullptr;
 }
 
 bool map::dangerous_field_at( const tripoint &p )
@@ -5509,7 +5542,7 @@ bool map::add_field( const tripoint &p, const field_type_id type, int intensity,
     submap *const current_submap = get_submap_at( p, l );
     current_submap->is_uniform = false;
 
-    if( current_submap->fld[l.x][l.y].add_field( type, intensity, age ) ) {
+    if( current_submap->fld.get( l ).add_field( type, intensity, age ) ) {
         //Only adding it to the count if it doesn't exist.
         if( ! current_submap->field_count++ ) {
             get_cache( p.z ).field_cache.set( static_cast<size_t>( p.x / SEEX + ( (
@@ -5523,10 +5556,10 @@ bool map::add_field( const tripoint &p, const field_type_id type, int intensity,
 
     // Dirty the transparency cache now that field processing doesn't always do it
     // TODO: Make it skip transparent fields
-    set_transparency_cache_dirty( p.z );
+    set_transparency_cache_dirty( p );
 
     if( type.obj().is_dangerous() ) {
-        set_pathfinding_cache_dirty( p.z );
+        set_pathfinding_cache_dirty( p );
     }
 
     // Ensure blood type fields don't hang in the air
@@ -5546,7 +5579,9 @@ void map::remove_field( const tripoint &p, const field_type_id field_to_remove )
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
-    if( current_submap->fld[l.x][l.y].remove_field( field_to_remove ) ) {
+    field *const fields = current_submap->fld.find( l );
+    if( fields != nullptr && fields->remove_field( field_to_remove ) ) {
+        current_submap->emptied_tiles = true;
         // Only adjust the count if the field actually existed.
         if( ! --current_submap->field_count ) {
             get_cache( p.z ).field_cache.set( static_cast<size_t>( p.x / SEEX + ( (
@@ -5554,10 +5589,10 @@ void map::remove_field( const tripoint &p, const field_type_id field_to_remove )
         }
         const auto &fdata = field_to_remove.obj();
         if( fdata.is_transparent() ) {
-            set_transparency_cache_dirty( p.z );
+            set_transparency_cache_dirty( p );
         }
         if( fdata.is_dangerous() ) {
-            set_pathfinding_cache_dirty( p.z );
+            set_pathfinding_cache_dirty( p );
         }
     }
 }
@@ -6188,14 +6223,22 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range, int &bres
         bresenham_slope = 0;
         return false; // Out of range!
     }
+    // The range is checked above and the line itself does not depend on it, so all ranges
+    // share the entry. Lines with another start offset (see find_clear_path) are not cached.
+    const bool use_cache = bresenham_slope == 0;
     // Cannonicalize the order of the tripoints so the cache is reflexive.
-    const tripoint &min = F < T ? F : T;
-    const tripoint &max = !( F < T ) ? F : T;
-    // A little gross, just pack the values into a point.
-    const point key( min.x << 16 | min.y << 8 | min.z, max.x << 16 | max.y << 8 | max.z );
-    char cached = skew_vision_cache.get( key, -1 );
-    if( cached >= 0 ) {
-        return cached > 0;
+    const std::pair<tripoint, tripoint> key = F < T ? std::make_pair( F, T ) : std::make_pair( T, F );
+    if( use_cache ) {
+        if( sight_line_cache_turn != calendar::turn ) {
+            invalidate_sight_line_cache();
+            sight_line_cache_turn = calendar::turn;
+        }
+        const auto cached = sight_line_cache.find( key );
+        if( cached != sight_line_cache.end() ) {
+            sight_line_stats.hits++;
+            return cached->second;
+        }
+        sight_line_stats.misses++;
     }
     bool visible = true;
 
@@ -6213,7 +6256,9 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range, int &bres
             }
             return true;
         } );
-        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        if( use_cache ) {
+            sight_line_cache.emplace( key, visible );
+        }
         return visible;
     }
 
@@ -6245,10 +6290,20 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range, int &bres
         last_point = new_point;
         return true;
     } );
-    skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    if( use_cache ) {
+        sight_line_cache.emplace( key, visible );
+    }
     return visible;
 }
 
+void map::invalidate_sight_line_cache() const
+{
+    if( !sight_line_cache.empty() ) {
+        sight_line_cache.clear();
+        sight_line_stats.invalidations++;
+    }
+}
+
 int map::obstacle_coverage( const tripoint &loc1, const tripoint &loc2 ) const
 {
     // Can't hide if you are standing on furniture, or non-flat slowing-down terrain tile.
@@ -6645,8 +6700,28 @@ void map::shift( const point &sp )
         return; // Skip this?
     }
     const tripoint abs = get_abs_sub();
+    const int zmin = zlevels ? -OVERMAP_DEPTH : abs.z;
+    const int zmax = zlevels ? OVERMAP_HEIGHT : abs.z;
+
+    // The submaps leaving the bubble keep no storage for tiles that lost their items or fields.
+    for( int gridz = zmin; gridz <= zmax; gridz++ ) {
+        for( int gridx = 0; gridx < my_MAPSIZE; gridx++ ) {
+            for( int gridy = 0; gridy < my_MAPSIZE; gridy++ ) {
+                const int destx = gridx - sp.x;
+                const int desty = gridy - sp.y;
+                if( destx >= 0 && destx < my_MAPSIZE && desty >= 0 && desty < my_MAPSIZE ) {
+                    continue;
+                }
+                if( submap *const leaving = get_submap_at_grid( { gridx, gridy, gridz } ) ) {
+                    leaving->release_empty_tiles();
+                }
+            }
+        }
+    }
 
     set_abs_sub( abs + sp );
+    // The cached lines are in local coordinates.
+    invalidate_sight_line_cache();
 
     // if player is in vehicle, (s)he must be shifted with vehicle too
     if( g->u.in_vehicle ) {
@@ -6658,8 +6733,6 @@ void map::shift( const point &sp )
 
     vehicle *remoteveh = g->remoteveh();
 
-    const int zmin = zlevels ? -OVERMAP_DEPTH : abs.z;
-    const int zmax = zlevels ? OVERMAP_HEIGHT : abs.z;
     for( int gridz = zmin; gridz <= zmax; gridz++ ) {
         for( vehicle *veh : get_cache( gridz ).vehicle_list ) {
             veh->zones_dirty = true;
@@ -7320,7 +7393,9 @@ void map::actualize( const tripoint &grid )
             }
             // plants contain a seed item which must not be removed under any circumstances
             if( !furn.has_flag( "DONT_REMOVE_ROTTEN" ) ) {
-                remove_rotten_items( tmpsub->itm[x][y], pnt );
+                if( cata::colony<item> *const items = tmpsub->itm.find( p ) ) {
+                    remove_rotten_items( *items, pnt );
+                }
             }
 
             const auto trap_here = tmpsub->get_trap( p );
@@ -7798,8 +7873,12 @@ void map::build_outside_cache( const int zlev )
 {
     auto &ch = get_cache( zlev );
     if( !ch.outside_cache_dirty ) {
+        if( ch.outside_dirty_submaps.any() ) {
+            build_outside_cache_submaps( zlev );
+        }
         return;
     }
+    ch.outside_dirty_submaps.reset();
 
     // Make a bigger cache to avoid bounds checking
     // We will later copy it to our regular cache
@@ -7848,6 +7927,49 @@ void map::build_outside_cache( const int zlev )
     ch.outside_cache_dirty = false;
 }
 
+void map::build_outside_cache_submaps( const int zlev )
+{
+    auto &ch = get_cache( zlev );
+    auto &outside_cache = ch.outside_cache;
+    auto &dirty_submaps = ch.outside_dirty_submaps;
+    if( zlev < 0 ) {
+        // Already all false
+        dirty_submaps.reset();
+        return;
+    }
+
+    const int max_x = SEEX * my_MAPSIZE - 1;
+    const int max_y = SEEY * my_MAPSIZE - 1;
+    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !dirty_submaps[smx + smy * MAPSIZE] ) {
+                continue;
+            }
+            // Indoor tiles also make their neighbors inside, so the border of the submap
+            // has to be recalculated as well
+            for( int x = std::max( 0, smx * SEEX - 1 ); x <= std::min( max_x, ( smx + 1 ) * SEEX ); x++ ) {
+                for( int y = std::max( 0, smy * SEEY - 1 ); y <= std::min( max_y, ( smy + 1 ) * SEEY ); y++ ) {
+                    bool outside = true;
+                    for( int dx = std::max( 0, x - 1 ); outside && dx <= std::min( max_x, x + 1 ); dx++ ) {
+                        for( int dy = std::max( 0, y - 1 ); dy <= std::min( max_y, y + 1 ); dy++ ) {
+                            if( has_flag_ter_or_furn( TFLAG_INDOORS, tripoint( dx, dy, zlev ) ) ) {
+                                outside = false;
+                                break;
+                            }
+                        }
+                    }
+                    if( outside_cache[x][y] != outside ) {
+                        outside_cache[x][y] = outside;
+                        // Weather only penalizes sight outside
+                        ch.transparency_dirty_submaps.set( dirty_submap_index( tripoint( x, y, zlev ) ) );
+                    }
+                }
+            }
+        }
+    }
+    dirty_submaps.reset();
+}
+
 void map::build_obstacle_cache( const tripoint &start, const tripoint &end,
                                 fragment_cloud( &obstacle_cache )[MAPSIZE_X][MAPSIZE_Y] )
 {
@@ -7922,33 +8044,53 @@ void map::build_obstacle_cache( const tripoint &start, const tripoint &end,
 bool map::build_floor_cache( const int zlev )
 {
     auto &ch = get_cache( zlev );
-    if( !ch.floor_cache_dirty ) {
+    if( !ch.floor_cache_dirty && ch.floor_dirty_submaps.none() ) {
         return false;
     }
 
     auto &floor_cache = ch.floor_cache;
+    const auto build_submap = [&]( const int smx, const int smy ) {
+        const auto cur_submap = get_submap_at_grid( { smx, smy, zlev } );
+
+        for( int sx = 0; sx < SEEX; ++sx ) {
+            for( int sy = 0; sy < SEEY; ++sy ) {
+                // Note: furniture currently can't affect existence of floor
+                const ter_t &terrain = cur_submap->get_ter( { sx, sy } ).obj();
+                const int x = sx + smx * SEEX;
+                const int y = sy + smy * SEEY;
+                floor_cache[x][y] = !terrain.has_flag( TFLAG_NO_FLOOR );
+            }
+        }
+    };
+
+    if( !ch.floor_cache_dirty ) {
+        // Only rebuild the submaps that changed. The floor decides what is seen of this level
+        // and of the one below.
+        const bool seen_dirty = zlevels && ( any_submap_seen( ch.floor_dirty_submaps, zlev ) ||
+                                             ( zlev > -OVERMAP_DEPTH &&
+                                               any_submap_seen( ch.floor_dirty_submaps, zlev - 1 ) ) );
+        for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+            for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+                if( ch.floor_dirty_submaps[smx + smy * MAPSIZE] ) {
+                    build_submap( smx, smy );
+                }
+            }
+        }
+        ch.floor_dirty_submaps.reset();
+        return seen_dirty;
+    }
+
     std::uninitialized_fill_n(
         &floor_cache[0][0], ( MAPSIZE_X ) * ( MAPSIZE_Y ), true );
 
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            const auto cur_submap = get_submap_at_grid( { smx, smy, zlev } );
-
-            for( int sx = 0; sx < SEEX; ++sx ) {
-                for( int sy = 0; sy < SEEY; ++sy ) {
-                    // Note: furniture currently can't affect existence of floor
-                    const ter_t &terrain = cur_submap->get_ter( { sx, sy } ).obj();
-                    if( terrain.has_flag( TFLAG_NO_FLOOR ) ) {
-                        const int x = sx + smx * SEEX;
-                        const int y = sy + smy * SEEY;
-                        floor_cache[x][y] = false;
-                    }
-                }
-            }
+            build_submap( smx, smy );
         }
     }
 
     ch.floor_cache_dirty = false;
+    ch.floor_dirty_submaps.reset();
     return zlevels;
 }
 
@@ -7956,9 +8098,16 @@ void map::build_floor_caches()
 {
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
+    bool sight_lines_dirty = false;
     for( int z = minz; z <= maxz; z++ ) {
+        const level_cache &ch = get_cache_ref( z );
+        // See build_map_cache, the floor decides what monsters see as well.
+        sight_lines_dirty |= ch.floor_cache_dirty || ch.floor_dirty_submaps.any();
         build_floor_cache( z );
     }
+    if( sight_lines_dirty ) {
+        invalidate_sight_line_cache();
+    }
 }
 
 void map::do_vehicle_caching( int z )
@@ -8005,10 +8154,24 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     const int minz = zlevels ? -OVERMAP_DEPTH : zlev;
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
     bool seen_cache_dirty = false;
+    // Changes out of the player's view don't dirty the seen cache, but they may still change
+    // what monsters see.
+    bool sight_lines_dirty = false;
     for( int z = minz; z <= maxz; z++ ) {
+        const level_cache &ch = get_cache_ref( z );
+        sight_lines_dirty |= ch.transparency_cache_dirty || ch.transparency_dirty_submaps.any() ||
+                             ch.floor_cache_dirty || ch.floor_dirty_submaps.any();
+    }
+    // The levels only touch their own caches, so they can be built concurrently
+    std::array<bool, OVERMAP_LAYERS> level_seen_dirty;
+    parallel_for( maxz - minz + 1, [&]( const int i ) {
+        const int z = minz + i;
         build_outside_cache( z );
-        seen_cache_dirty |= build_transparency_cache( z );
-        seen_cache_dirty |= build_floor_cache( z );
+        level_seen_dirty[i] = build_transparency_cache( z );
+        level_seen_dirty[i] |= build_floor_cache( z );
+    } );
+    for( int z = minz; z <= maxz; z++ ) {
+        seen_cache_dirty |= level_seen_dirty[z - minz];
         do_vehicle_caching( z );
     }
 
@@ -8028,8 +8191,8 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
         }
     }
 
-    if( seen_cache_dirty ) {
-        skew_vision_cache.clear();
+    if( seen_cache_dirty || sight_lines_dirty ) {
+        invalidate_sight_line_cache();
     }
     // Initial value is illegal player position.
     static tripoint player_prev_pos;
@@ -8625,13 +8788,15 @@ level_cache::level_cache()
     std::fill_n( &camera_cache[0][0], map_dimensions, 0.0f );
     std::fill_n( &visibility_cache[0][0], map_dimensions, LL_DARK );
     veh_in_active_range = false;
-    std::fill_n( &veh_exists_at[0][0], map_dimensions, false );
+    std::fill_n( &veh_cached_at[0][0], map_dimensions, std::make_pair( nullptr, -1 ) );
     max_populated_zlev = OVERMAP_HEIGHT;
 }
 
 pathfinding_cache::pathfinding_cache()
 {
     dirty = true;
+    version = 0;
+    portals_dirty_submaps.set();
 }
 
 pathfinding_cache::~pathfinding_cache() = default;
@@ -8644,7 +8809,18 @@ pathfinding_cache &map::get_pathfinding_cache( int zlev ) const
 void map::set_pathfinding_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
-        get_pathfinding_cache( zlev ).dirty = true;
+        pathfinding_cache &cache = get_pathfinding_cache( zlev );
+        cache.dirty = true;
+        cache.portals_dirty_submaps.set();
+    }
+}
+
+void map::set_pathfinding_cache_dirty( const tripoint &p )
+{
+    if( inbounds( p ) ) {
+        pathfinding_cache &cache = get_pathfinding_cache( p.z );
+        cache.dirty = true;
+        cache.portals_dirty_submaps.set( dirty_submap_index( p ) );
     }
 }
 
@@ -8670,6 +8846,7 @@ void map::update_pathfinding_cache( int zlev ) const
     }
 
     std::uninitialized_fill_n( &cache.special[0][0], MAPSIZE_X * MAPSIZE_Y, PF_NORMAL );
+    cache.version++;
 
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
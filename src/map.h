@@ -15,15 +15,16 @@
 #include <functional>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 
 #include "calendar.h"
 #include "colony.h"
 #include "enums.h"
 #include "game_constants.h"
+#include "hash_utils.h"
 #include "item.h"
 #include "item_stack.h"
 #include "lightmap.h"
-#include "lru_cache.h"
 #include "shadowcasting.h"
 #include "type_id.h"
 #include "units.h"
@@ -88,8 +89,11 @@ using items_location = std::string;
 class map;
 
 enum ter_bitflags : int;
+struct flow_field;
 struct pathfinding_cache;
 struct pathfinding_settings;
+struct pathfinding_step;
+enum pf_special : char;
 template<typename T>
 struct weighted_int_list;
 
@@ -149,9 +153,14 @@ struct level_cache {
     level_cache(); // Zeros all relevant values
     level_cache( const level_cache &other ) = default;
 
+    // Whole z-level needs to be rebuilt
     bool transparency_cache_dirty;
     bool outside_cache_dirty;
     bool floor_cache_dirty;
+    // Only the marked submaps (indexed like field_cache) need to be rebuilt
+    std::bitset<MAPSIZE *MAPSIZE> transparency_dirty_submaps;
+    std::bitset<MAPSIZE *MAPSIZE> outside_dirty_submaps;
+    std::bitset<MAPSIZE *MAPSIZE> floor_dirty_submaps;
 
     four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
     float sm[MAPSIZE_X][MAPSIZE_Y];
@@ -168,7 +177,8 @@ struct level_cache {
     std::bitset<MAPSIZE *MAPSIZE> field_cache;
 
     bool veh_in_active_range;
-    bool veh_exists_at[MAPSIZE_X][MAPSIZE_Y];
+    /** Vehicle and part index at each point of veh_cached_parts in bounds, nullptr if none. */
+    std::pair<vehicle *, int> veh_cached_at[MAPSIZE_X][MAPSIZE_Y];
     std::map< tripoint, std::pair<vehicle *, int> > veh_cached_parts;
     std::set<vehicle *> vehicle_list;
     std::set<vehicle *> zone_vehicles;
@@ -176,6 +186,18 @@ struct level_cache {
     int max_populated_zlev;
 };
 
+/** Counters of the line of sight cache used by @ref map::sees. */
+struct sight_line_cache_stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    /** How often the cache was emptied because the turn or the transparency changed. */
+    uint64_t invalidations = 0;
+
+    double hit_rate() const {
+        return hits + misses == 0 ? 0.0 : static_cast<double>( hits ) / ( hits + misses );
+    }
+};
+
 /**
  * Manage and cache data about a part of the map.
  *
@@ -236,7 +258,31 @@ class map
             }
         }
 
+        /**
+         * Same as above, but only the submap containing the given (local) point
+         * will be rebuilt.
+         */
+        void set_transparency_cache_dirty( const tripoint &p ) {
+            if( inbounds( p ) ) {
+                get_cache( p.z ).transparency_dirty_submaps.set( dirty_submap_index( p ) );
+            }
+        }
+
+        void set_outside_cache_dirty( const tripoint &p ) {
+            if( inbounds( p ) ) {
+                get_cache( p.z ).outside_dirty_submaps.set( dirty_submap_index( p ) );
+            }
+        }
+
+        void set_floor_cache_dirty( const tripoint &p ) {
+            if( inbounds( p ) ) {
+                get_cache( p.z ).floor_dirty_submaps.set( dirty_submap_index( p ) );
+            }
+        }
+
         void set_pathfinding_cache_dirty( int zlev );
+        // The portal graph is only rebuilt around the submap containing the point
+        void set_pathfinding_cache_dirty( const tripoint &p );
         /*@}*/
 
         void set_memory_seen_cache_dirty( const tripoint &p ) {
@@ -523,6 +569,23 @@ class map
         std::vector<tripoint> route( const tripoint &f, const tripoint &t,
                                      const pathfinding_settings &settings,
         const std::set<tripoint> &pre_closed = {{ }} ) const;
+        /**
+         * Like @ref route without closed points, but creatures converging on the same target
+         * with the same settings during a turn share a @ref flow_field of that target instead
+         * of searching on their own. Falls back to @ref route for targets requested only a
+         * few times.
+         */
+        std::vector<tripoint> route_shared( const tripoint &f, const tripoint &t,
+                                            const pathfinding_settings &settings ) const;
+        /**
+         * Like @ref route, but long routes are first planned on the portal graph of the
+         * pathfinding caches (see @ref pathfinding_cache::portals). Only the submaps along the
+         * planned corridor are searched tile by tile, so the route isn't limited to the
+         * search area of @ref route and can cross the whole map.
+         */
+        std::vector<tripoint> route_hierarchical( const tripoint &f, const tripoint &t,
+                const pathfinding_settings &settings,
+        const std::set<tripoint> &pre_closed = {{ }} ) const;
 
         // Vehicles: Common to 2D and 3D
         VehicleList get_vehicles();
@@ -908,6 +971,12 @@ class map
 
         // Items
         void process_active_items();
+        /**
+         * Releases the storage of the tiles in the bubble that lost their items or fields,
+         * see @ref submap::release_empty_tiles. This invalidates item stacks and fields of
+         * the map that are still referenced, so it is only done between turns.
+         */
+        void release_empty_tiles();
 
         // Items: 2D
         map_stack i_at( const point &p );
@@ -930,6 +999,8 @@ class map
         void create_anomaly( const point &c, artifact_natural_property prop );
         // Items: 3D
         // Accessor that returns a wrapped reference to an item stack for safe modification.
+        // A tile without items gets storage for them, it is released at the end of the turn
+        // if it stays empty. Use has_items() to only check for items.
         map_stack i_at( const tripoint &p );
         item water_from( const tripoint &p );
         void i_clear( const tripoint &p );
@@ -1079,6 +1150,8 @@ class map
         const field &field_at( const tripoint &p ) const;
         /**
          * Gets fields that are here. Both for querying and edition.
+         * A tile without fields gets storage for them, it is released at the end of the
+         * turn if it stays empty.
          */
         field &field_at( const tripoint &p );
         /**
@@ -1444,6 +1517,14 @@ class map
         // Used to determine if seen cache should be rebuilt.
         bool build_transparency_cache( int zlev );
         void build_sunlight_cache( int zlev );
+        static size_t dirty_submap_index( const tripoint &p ) {
+            return static_cast<size_t>( p.x / SEEX + ( p.y / SEEY ) * MAPSIZE );
+        }
+        // Returns true if any tile of the marked submaps was visible when the seen cache was last built.
+        // Changes to submaps that couldn't be seen can't change what is seen now.
+        bool any_submap_seen( const std::bitset<MAPSIZE *MAPSIZE> &submaps, int zlev ) const;
+        // Rebuilds only the submaps marked in outside_dirty_submaps
+        void build_outside_cache_submaps( int zlev );
     public:
         void build_outside_cache( int zlev );
         // Builds a floor cache and returns true if the cache was invalidated.
@@ -1527,6 +1608,10 @@ class map
         int bash_rating_internal( int str, const furn_t &furniture,
                                   const ter_t &terrain, bool allow_floor,
                                   const vehicle *veh, int part ) const;
+        /** Cost of stepping from @p cur onto the adjacent @p p when pathfinding with @p settings. */
+        pathfinding_step route_step( const tripoint &cur, const tripoint &p, pf_special p_special,
+                                     const pathfinding_settings &settings ) const;
+        void build_flow_field( flow_field &field ) const;
 
         /**
          * Internal version of the drawsq. Keeps a cached maptile for less re-getting.
@@ -1551,6 +1636,12 @@ class map
         int determine_wall_corner( const tripoint &p ) const;
         // apply a circular light pattern immediately, however it's best to use...
         void apply_light_source( const tripoint &p, float luminance );
+        // Same as above, but lights the given arrays instead of the level cache.
+        void apply_light_source( const tripoint &p, float luminance,
+                                 four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                                 float ( &sm )[MAPSIZE_X][MAPSIZE_Y] ) const;
+        // Applies the light sources gathered by add_light_source, split across the worker threads.
+        void apply_buffered_light_sources( int zlev, const std::vector<tripoint> &sources );
         // ...this, which will apply the light after at the end of generate_lightmap, and prevent redundant
         // light rays from causing massive slowdowns, if there's a huge amount of light.
         void add_light_source( const tripoint &p, float luminance );
@@ -1641,15 +1732,25 @@ class map
         std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        /** Fields requested by @ref route_shared during @ref flow_fields_turn. */
+        mutable std::vector<std::unique_ptr<flow_field>> flow_fields;
+        mutable time_point flow_fields_turn = calendar::before_time_starts;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
         std::set<tripoint> submaps_with_active_items;
 
         /**
-         * Cache of coordinate pairs recently checked for visibility.
+         * Results of @ref sees during @ref sight_line_cache_turn, by the two points in
+         * ascending order. Only valid as long as the transparency and floor caches are not
+         * rebuilt, see @ref invalidate_sight_line_cache.
          */
-        mutable lru_cache<point, char> skew_vision_cache;
+        mutable std::unordered_map<std::pair<tripoint, tripoint>, bool, cata::tuple_hash>
+        sight_line_cache;
+        mutable time_point sight_line_cache_turn = calendar::before_time_starts;
+        mutable sight_line_cache_stats sight_line_stats;
+
+        void invalidate_sight_line_cache() const;
 
         // Note: no bounds check
         level_cache &get_cache( int zlev ) const {
@@ -1666,6 +1767,16 @@ class map
         }
 
         const pathfinding_cache &get_pathfinding_cache_ref( int zlev ) const;
+        /** The pathfinding cache of the z-level with its portal graph built. */
+        const pathfinding_cache &get_portals( int zlev ) const;
+
+        /** Hit counters of the cache behind @ref sees, since the last reset. */
+        const sight_line_cache_stats &get_sight_line_cache_stats() const {
+            return sight_line_stats;
+        }
+        void reset_sight_line_cache_stats() {
+            sight_line_stats = sight_line_cache_stats();
+        }
 
         void update_pathfinding_cache( int zlev ) const;
 
@@ -132,28 +132,31 @@ bool map::process_fields()
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
     for( int z = minz; z <= maxz; z++ ) {
-        bool zlev_dirty = false;
         auto &field_cache = get_cache( z ).field_cache;
         for( int x = 0; x < my_MAPSIZE; x++ ) {
             for( int y = 0; y < my_MAPSIZE; y++ ) {
                 if( field_cache[ x + y * MAPSIZE ] ) {
                     submap *const current_submap = get_submap_at_grid( { x, y, z } );
                     const bool cur_dirty = process_fields_in_submap( current_submap, tripoint( x, y, z ) );
-                    zlev_dirty |= cur_dirty;
+                    if( !cur_dirty ) {
+                        continue;
+                    }
+                    // For now, just always dirty the transparency cache
+                    // when a field might possibly be changed.
+                    // Fields spread to the neighboring submaps, so those are dirtied too.
+                    // TODO: check if there are any fields(mostly fire)
+                    //       that frequently change, if so set the dirty
+                    //       flag, otherwise only set the dirty flag if
+                    //       something actually changed
+                    for( int dx = -1; dx <= 1; dx++ ) {
+                        for( int dy = -1; dy <= 1; dy++ ) {
+                            set_transparency_cache_dirty( tripoint( ( x + dx ) * SEEX, ( y + dy ) * SEEY, z ) );
+                        }
+                    }
+                    dirty_transparency_cache = true;
                 }
             }
         }
-
-        if( zlev_dirty ) {
-            // For now, just always dirty the transparency cache
-            // when a field might possibly be changed.
-            // TODO: check if there are any fields(mostly fire)
-            //       that frequently change, if so set the dirty
-            //       flag, otherwise only set the dirty flag if
-            //       something actually changed
-            set_transparency_cache_dirty( z );
-            dirty_transparency_cache = true;
-        }
     }
 
     return dirty_transparency_cache;
@@ -404,7 +407,11 @@ bool map::process_fields_in_submap( submap *const current_submap,
             const tripoint &p = thep;
             // Get a reference to the field variable from the submap;
             // contains all the pointers to the real field effects.
-            field &curfield = current_submap->fld[locx][locy];
+            field *const tile_fields = current_submap->fld.find( map_tile.pos() );
+            if( tile_fields == nullptr ) {
+                continue;
+            }
+            field &curfield = *tile_fields;
             for( auto it = curfield.begin(); it != curfield.end(); ) {
                 // Iterating through all field effects in the submap's field.
                 field_entry &cur = it->second;
@@ -414,6 +421,7 @@ bool map::process_fields_in_submap( submap *const current_submap,
                         dirty_transparency_cache = true;
                     }
                     --current_submap->field_count;
+                    current_submap->emptied_tiles = true;
                     curfield.remove_field( it++ );
                     continue;
                 }
@@ -1299,6 +1307,7 @@ bool map::process_fields_in_submap( submap *const current_submap,
                 }
                 if( !cur.is_field_alive() ) {
                     --current_submap->field_count;
+                    current_submap->emptied_tiles = true;
                     curfield.remove_field( it++ );
                 } else {
                     ++it;
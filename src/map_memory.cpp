@@ -1,30 +1,177 @@
 #include "map_memory.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "coordinate_conversions.h"
+
 static const memorized_terrain_tile default_tile{ "", 0, 0 };
 
+map_memory::memorized_submap::memorized_submap()
+{
+    tiles.fill( 0 );
+    subtiles.fill( 0 );
+    rotations.fill( 0 );
+    symbols.fill( 0 );
+}
+
+map_memory::map_memory( const map_memory &other ) : chunks( other.chunks ), lru( other.lru ),
+    memorized_tiles( other.memorized_tiles ), tile_names( other.tile_names ),
+    tile_ids( other.tile_ids )
+{
+    relink_lru();
+}
+
+map_memory &map_memory::operator=( const map_memory &other )
+{
+    map_memory copy( other );
+    *this = std::move( copy );
+    return *this;
+}
+
+void map_memory::relink_lru()
+{
+    for( auto iter = lru.begin(); iter != lru.end(); ++iter ) {
+        chunks[*iter].lru_position = iter;
+    }
+}
+
+static size_t index_in_chunk( const tripoint &pos, tripoint &chunk_pos )
+{
+    chunk_pos = ms_to_sm_copy( pos );
+    const point offset = pos.xy() - sm_to_ms_copy( chunk_pos.xy() );
+    return offset.x + offset.y * SEEX;
+}
+
+map_memory::memorized_submap &map_memory::get_chunk( const tripoint &pos, size_t &index )
+{
+    tripoint chunk_pos;
+    index = index_in_chunk( pos, chunk_pos );
+    const auto inserted = chunks.emplace( chunk_pos, memorized_submap() );
+    memorized_submap &chunk = inserted.first->second;
+    if( inserted.second ) {
+        chunk.lru_position = lru.insert( lru.end(), chunk_pos );
+    } else {
+        // Writing to a chunk makes it the most recently used one.
+        lru.splice( lru.end(), lru, chunk.lru_position );
+    }
+    return chunk;
+}
+
+const map_memory::memorized_submap *map_memory::find_chunk( const tripoint &pos,
+        size_t &index ) const
+{
+    tripoint chunk_pos;
+    index = index_in_chunk( pos, chunk_pos );
+    const auto iter = chunks.find( chunk_pos );
+    return iter == chunks.end() ? nullptr : &iter->second;
+}
+
+int map_memory::intern_tile( const std::string &tile )
+{
+    if( tile.empty() ) {
+        return 0;
+    }
+    const auto inserted = tile_ids.emplace( tile, static_cast<int>( tile_names.size() ) );
+    if( inserted.second ) {
+        tile_names.push_back( tile );
+    }
+    return inserted.first->second;
+}
+
+void map_memory::trim( const int limit )
+{
+    // The chunk written last is never forgotten, even if it alone exceeds the limit.
+    while( memorized_tiles > static_cast<size_t>( std::max( limit, 0 ) ) && lru.size() > 1 ) {
+        const auto iter = chunks.find( lru.front() );
+        memorized_tiles -= iter->second.memorized;
+        chunks.erase( iter );
+        lru.pop_front();
+    }
+}
+
+void map_memory::update_memorized( memorized_submap &chunk, const size_t index,
+                                   const bool had_memory )
+{
+    const bool has_memory = chunk.has_memory( index );
+    if( has_memory && !had_memory ) {
+        chunk.memorized++;
+        memorized_tiles++;
+    } else if( !has_memory && had_memory ) {
+        chunk.memorized--;
+        memorized_tiles--;
+    }
+}
+
+void map_memory::clear()
+{
+    chunks.clear();
+    lru.clear();
+    memorized_tiles = 0;
+}
+
 memorized_terrain_tile map_memory::get_tile( const tripoint &pos ) const
 {
-    return tile_cache.get( pos, default_tile );
+    size_t index = 0;
+    const memorized_submap *chunk = find_chunk( pos, index );
+    if( chunk == nullptr || chunk->tiles[index] == 0 ) {
+        return default_tile;
+    }
+    return memorized_terrain_tile{ tile_names[chunk->tiles[index]], chunk->subtiles[index],
+                                   chunk->rotations[index] };
 }
 
 void map_memory::memorize_tile( int limit, const tripoint &pos, const std::string &ter,
                                 const int subtile, const int rotation )
 {
-    tile_cache.insert( limit, pos, memorized_terrain_tile{ ter, subtile, rotation } );
+    const int tile_id = intern_tile( ter );
+    size_t index = 0;
+    memorized_submap &chunk = get_chunk( pos, index );
+    const bool had_memory = chunk.has_memory( index );
+    chunk.tiles[index] = tile_id;
+    chunk.subtiles[index] = subtile;
+    chunk.rotations[index] = rotation;
+    update_memorized( chunk, index, had_memory );
+    trim( limit );
 }
 
 int map_memory::get_symbol( const tripoint &pos ) const
 {
-    return symbol_cache.get( pos, 0 );
+    size_t index = 0;
+    const memorized_submap *chunk = find_chunk( pos, index );
+    return chunk == nullptr ? 0 : chunk->symbols[index];
 }
 
 void map_memory::memorize_symbol( int limit, const tripoint &pos, const int symbol )
 {
-    symbol_cache.insert( limit, pos, symbol );
+    size_t index = 0;
+    memorized_submap &chunk = get_chunk( pos, index );
+    const bool had_memory = chunk.has_memory( index );
+    chunk.symbols[index] = symbol;
+    update_memorized( chunk, index, had_memory );
+    trim( limit );
 }
 
 void map_memory::clear_memorized_tile( const tripoint &pos )
 {
-    tile_cache.remove( pos );
-    symbol_cache.remove( pos );
+    tripoint chunk_pos;
+    const size_t index = index_in_chunk( pos, chunk_pos );
+    const auto iter = chunks.find( chunk_pos );
+    if( iter == chunks.end() ) {
+        return;
+    }
+    memorized_submap &chunk = iter->second;
+    if( !chunk.has_memory( index ) ) {
+        return;
+    }
+    chunk.tiles[index] = 0;
+    chunk.subtiles[index] = 0;
+    chunk.rotations[index] = 0;
+    chunk.symbols[index] = 0;
+    chunk.memorized--;
+    memorized_tiles--;
+    if( chunk.memorized == 0 ) {
+        lru.erase( chunk.lru_position );
+        chunks.erase( iter );
+    }
 }
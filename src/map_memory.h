@@ -2,9 +2,13 @@
 #ifndef MAP_MEMORY_H
 #define MAP_MEMORY_H
 
+#include <array>
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
-#include "lru_cache.h"
+#include "game_constants.h"
 #include "point.h" // IWYU pragma: keep
 
 class JsonOut;
@@ -17,9 +21,22 @@ struct memorized_terrain_tile {
     int rotation;
 };
 
+/**
+ * Remembered tiles and symbols of the player character.
+ *
+ * Memory is stored in chunks of one submap each, tile names are interned and only their
+ * ids are stored per tile. When the limit is exceeded, the chunks that have been written to
+ * least recently are forgotten as a whole.
+ */
 class map_memory
 {
     public:
+        map_memory() = default;
+        map_memory( const map_memory &other );
+        map_memory( map_memory && ) = default;
+        map_memory &operator=( const map_memory &other );
+        map_memory &operator=( map_memory && ) = default;
+
         void store( JsonOut &jsout ) const;
         void load( JsonIn &jsin );
         void load( JsonObject &jsin );
@@ -34,9 +51,51 @@ class map_memory
         int get_symbol( const tripoint &pos ) const;
 
         void clear_memorized_tile( const tripoint &pos );
+
+        /** Number of locations that have a tile or a symbol memorized. */
+        size_t size() const {
+            return memorized_tiles;
+        }
     private:
-        lru_cache<tripoint, memorized_terrain_tile> tile_cache;
-        lru_cache<tripoint, int> symbol_cache;
+        static constexpr size_t chunk_size = SEEX * SEEY;
+
+        struct memorized_submap {
+            /** Index into @ref tile_names, 0 means no tile memorized. */
+            std::array<int, chunk_size> tiles;
+            std::array<short, chunk_size> subtiles;
+            std::array<short, chunk_size> rotations;
+            /** 0 means no symbol memorized. */
+            std::array<int, chunk_size> symbols;
+            /** Number of locations with a tile or a symbol. */
+            int memorized = 0;
+            /** Position of the chunk in @ref lru. */
+            std::list<tripoint>::iterator lru_position;
+
+            memorized_submap();
+            bool has_memory( size_t index ) const {
+                return tiles[index] != 0 || symbols[index] != 0;
+            }
+        };
+
+        /** Returns the chunk containing @p pos (creating it) and the index of @p pos in it. */
+        memorized_submap &get_chunk( const tripoint &pos, size_t &index );
+        const memorized_submap *find_chunk( const tripoint &pos, size_t &index ) const;
+        int intern_tile( const std::string &tile );
+        /** Updates the memorized counts after the location @p index in @p chunk was written. */
+        void update_memorized( memorized_submap &chunk, size_t index, bool had_memory );
+        /** Forgets the least recently written chunks until at most @p limit locations remain. */
+        void trim( int limit );
+        void clear();
+        /** Points the chunks to their entries in @ref lru, needed after copying. */
+        void relink_lru();
+
+        std::unordered_map<tripoint, memorized_submap> chunks;
+        /** Chunk positions (in absolute submap coordinates), least recently written first. */
+        std::list<tripoint> lru;
+        size_t memorized_tiles = 0;
+
+        std::vector<std::string> tile_names = { std::string() };
+        std::unordered_map<std::string, int> tile_ids;
 };
 
 #endif
@@ -0,0 +1,202 @@
+#include "map_segment.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "cata_utility.h"
+#include "string_formatter.h"
+
+static const std::string segment_magic = "CDDASEG2";
+// Magic and offset of the offset table.
+static constexpr uint64_t header_size = 8 + 8;
+// Coordinates, offset and length of one quad.
+static constexpr uint64_t entry_size = 3 * 4 + 8 + 4;
+// Files smaller than this are never compacted.
+static constexpr uint64_t min_compact_size = 64 * 1024;
+
+static void write_uint( std::ostream &fout, uint64_t value, int bytes )
+{
+    for( int i = 0; i < bytes; i++ ) {
+        fout.put( static_cast<char>( value & 0xff ) );
+        value >>= 8;
+    }
+}
+
+static uint64_t read_uint( std::istream &fin, int bytes )
+{
+    uint64_t value = 0;
+    for( int i = 0; i < bytes; i++ ) {
+        const int c = fin.get();
+        if( c == std::char_traits<char>::eof() ) {
+            throw std::runtime_error( "unexpected end of segment file" );
+        }
+        value |= static_cast<uint64_t>( static_cast<unsigned char>( c ) ) << ( 8 * i );
+    }
+    return value;
+}
+
+static int32_t read_int( std::istream &fin )
+{
+    return static_cast<int32_t>( static_cast<uint32_t>( read_uint( fin, 4 ) ) );
+}
+
+map_segment_file::map_segment_file( const std::string &path ) : path( path )
+{
+}
+
+bool map_segment_file::load_index()
+{
+    index.clear();
+    end_offset = 0;
+    std::ifstream fin( path, std::ios::binary );
+    if( !fin.is_open() ) {
+        return false;
+    }
+    std::string magic( segment_magic.size(), '\0' );
+    fin.read( &magic[0], magic.size() );
+    if( !fin || magic != segment_magic ) {
+        throw std::runtime_error( string_format( "%s is not a map segment file", path ) );
+    }
+    const uint64_t table_offset = read_uint( fin, 8 );
+    fin.seekg( table_offset );
+    const uint64_t count = read_uint( fin, 4 );
+    for( uint64_t i = 0; i < count; i++ ) {
+        tripoint om_addr;
+        om_addr.x = read_int( fin );
+        om_addr.y = read_int( fin );
+        om_addr.z = read_int( fin );
+        entry e;
+        e.offset = read_uint( fin, 8 );
+        e.length = static_cast<uint32_t>( read_uint( fin, 4 ) );
+        index[om_addr] = e;
+    }
+    end_offset = table_offset + 4 + entry_size * count;
+    return true;
+}
+
+bool map_segment_file::has( const tripoint &om_addr ) const
+{
+    return index.count( om_addr ) != 0;
+}
+
+cata::optional<std::string> map_segment_file::read( const tripoint &om_addr ) const
+{
+    const auto iter = index.find( om_addr );
+    if( iter == index.end() ) {
+        return cata::nullopt;
+    }
+    std::ifstream fin( path, std::ios::binary );
+    if( !fin.is_open() ) {
+        throw std::runtime_error( string_format( "could not open %s", path ) );
+    }
+    std::string data( iter->second.length, '\0' );
+    fin.seekg( iter->second.offset );
+    fin.read( &data[0], data.size() );
+    if( !fin ) {
+        throw std::runtime_error( string_format( "could not read quad %d,%d,%d from %s",
+                                  om_addr.x, om_addr.y, om_addr.z, path ) );
+    }
+    return data;
+}
+
+std::map<tripoint, std::string> map_segment_file::read_all() const
+{
+    std::map<tripoint, std::string> result;
+    for( const auto &elem : index ) {
+        result[elem.first] = *read( elem.first );
+    }
+    return result;
+}
+
+std::string map_segment_file::serialize_header( const uint64_t table_offset ) const
+{
+    std::ostringstream fout;
+    fout.write( segment_magic.data(), segment_magic.size() );
+    write_uint( fout, table_offset, 8 );
+    return fout.str();
+}
+
+std::string map_segment_file::serialize_table() const
+{
+    std::ostringstream fout;
+    write_uint( fout, index.size(), 4 );
+    for( const auto &elem : index ) {
+        write_uint( fout, static_cast<uint32_t>( elem.first.x ), 4 );
+        write_uint( fout, static_cast<uint32_t>( elem.first.y ), 4 );
+        write_uint( fout, static_cast<uint32_t>( elem.first.z ), 4 );
+        write_uint( fout, elem.second.offset, 8 );
+        write_uint( fout, elem.second.length, 4 );
+    }
+    return fout.str();
+}
+
+file_patch map_segment_file::serialize( const std::map<tripoint, std::string> &quads )
+{
+    uint64_t live_size = 0;
+    size_t live_count = index.size();
+    for( const auto &elem : index ) {
+        if( quads.count( elem.first ) == 0 ) {
+            live_size += elem.second.length;
+        } else {
+            live_count--;
+        }
+    }
+    for( const auto &elem : quads ) {
+        live_size += elem.second.size();
+    }
+    live_count += quads.size();
+    const uint64_t compact_size = header_size + live_size + 4 + entry_size * live_count;
+
+    file_patch result;
+    if( end_offset == 0 || ( end_offset > min_compact_size && end_offset > 2 * compact_size ) ) {
+        // Quads that are not replaced are carried over from the current file.
+        std::map<tripoint, std::string> content = read_all();
+        for( const auto &elem : quads ) {
+            content[elem.first] = elem.second;
+        }
+        std::string data;
+        data.reserve( compact_size );
+        data.resize( header_size );
+        index.clear();
+        for( const auto &elem : content ) {
+            index[elem.first] = entry{ data.size(), static_cast<uint32_t>( elem.second.size() ) };
+            data += elem.second;
+        }
+        data.replace( 0, header_size, serialize_header( data.size() ) );
+        data += serialize_table();
+        end_offset = data.size();
+        result.emplace_back( 0, std::move( data ) );
+        return result;
+    }
+
+    // The old offset table stays valid until the header points to the new one.
+    std::string data;
+    uint64_t table_offset = end_offset;
+    for( const auto &elem : quads ) {
+        index[elem.first] = entry{ table_offset, static_cast<uint32_t>( elem.second.size() ) };
+        data += elem.second;
+        table_offset += elem.second.size();
+    }
+    const std::string table = serialize_table();
+    data += table;
+    result.emplace_back( end_offset, std::move( data ) );
+    result.emplace_back( segment_magic.size(),
+                         serialize_header( table_offset ).substr( segment_magic.size() ) );
+    end_offset = table_offset + table.size();
+    return result;
+}
+
+void map_segment_file::write( const std::map<tripoint, std::string> &quads )
+{
+    file_patch patch = serialize( quads );
+    if( patch.front().first == 0 ) {
+        const std::string &data = patch.front().second;
+        write_to_file( path, [&]( std::ostream & fout ) {
+            fout.write( data.data(), data.size() );
+        } );
+    } else {
+        patch_file( path, patch );
+    }
+}
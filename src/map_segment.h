@@ -0,0 +1,75 @@
+#pragma once
+#ifndef MAP_SEGMENT_H
+#define MAP_SEGMENT_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "background_writer.h"
+#include "optional.h"
+#include "point.h"
+
+/**
+ * A single file holding the saved submap quads of one map segment (see @ref omt_to_seg_copy).
+ *
+ * The file starts with a magic string and the offset of the offset table, followed by the data
+ * of the quads and finally the offset table (number of entries, then quad coordinates, offset
+ * and length of its data for each). The data of a quad is exactly what would otherwise be
+ * written to its own quad file, so converting between both layouts does not need to touch the
+ * submaps themselves.
+ * Saving only appends the changed quads and a new offset table, the header is switched over to
+ * them last. The data that is no longer referenced is dropped once it makes up most of the file.
+ * All numbers are stored little-endian.
+ */
+class map_segment_file
+{
+    public:
+        explicit map_segment_file( const std::string &path );
+
+        const std::string &get_path() const {
+            return path;
+        }
+        /**
+         * Reads the offset table of the file. Returns false if there is no such file.
+         * Throws if the file is not a valid segment file.
+         */
+        bool load_index();
+        /** Whether the quad (in overmap terrain coordinates) is in the offset table. */
+        bool has( const tripoint &om_addr ) const;
+        /** Reads the data of a single quad, returns nothing if the quad is not in the file. */
+        cata::optional<std::string> read( const tripoint &om_addr ) const;
+        /** Reads the data of all quads in the file. */
+        std::map<tripoint, std::string> read_all() const;
+        /**
+         * Updates the file with the given quads added to (or replacing) the ones already
+         * stored in it (according to the offset table, see @ref load_index).
+         * An interrupted write keeps the old content.
+         */
+        void write( const std::map<tripoint, std::string> &quads );
+        /**
+         * Like @ref write, but returns the changes to the file instead of applying them.
+         * If the first chunk starts at offset 0, it is the complete new file content, which
+         * replaces the file. Otherwise the chunks are to be applied with @ref patch_file.
+         * The offset table already describes the changed file, so it must be written
+         * before the next @ref read.
+         */
+        file_patch serialize( const std::map<tripoint, std::string> &quads );
+
+    private:
+        struct entry {
+            uint64_t offset;
+            uint32_t length;
+        };
+
+        /** Serializes the header and the offset table that starts at @p table_offset. */
+        std::string serialize_header( uint64_t table_offset ) const;
+        std::string serialize_table() const;
+
+        std::string path;
+        std::map<tripoint, entry> index;
+        /** Where the next data is appended, the end of the current offset table. */
+        uint64_t end_offset = 0;
+};
+
+#endif
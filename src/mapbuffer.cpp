@@ -1,12 +1,16 @@
 #include "mapbuffer.h"
 
+#include <cstdio>
 #include <algorithm>
 #include <exception>
 #include <functional>
+#include <iterator>
 #include <set>
+#include <sstream>
 #include <utility>
 #include <vector>
 
+#include "background_writer.h"
 #include "cata_utility.h"
 #include "coordinate_conversions.h"
 #include "debug.h"
@@ -14,7 +18,9 @@
 #include "game.h"
 #include "json.h"
 #include "map.h"
+#include "options.h"
 #include "output.h"
+#include "string_formatter.h"
 #include "submap.h"
 #include "translations.h"
 #include "game_constants.h"
@@ -36,6 +42,7 @@ void mapbuffer::reset()
         delete elem.second;
     }
     submaps.clear();
+    segment_files.clear();
 }
 
 bool mapbuffer::add_submap( const tripoint &p, submap *sm )
@@ -111,6 +118,11 @@ void mapbuffer::save( bool delete_after_save )
 
     const tripoint map_origin = sm_to_omt_copy( g->m.get_abs_sub() );
     const bool map_has_zlevels = g != nullptr && g->m.has_zlevels();
+    const bool use_segments = get_option<bool>( "SEGMENTED_MAP_FILES" );
+    // The quads are serialized here, writing the files happens in the background.
+    background_writer &writer = get_save_writer();
+    // Serialized quads by segment, only used when saving into segment files.
+    std::map<tripoint, std::map<tripoint, std::string>> segment_quads;
 
     // A set of already-saved submaps, in global overmap coordinates.
     std::set<tripoint> saved_submaps;
@@ -146,21 +158,183 @@ void mapbuffer::save( bool delete_after_save )
         // delete_on_save deletes everything, otherwise delete submaps
         // outside the current map.
         const bool zlev_del = !map_has_zlevels && om_addr.z != g->get_levz();
-        save_quad( dirname, quad_path, om_addr, submaps_to_delete,
-                   delete_after_save || zlev_del ||
-                   om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
-                   om_addr.x > map_origin.x + HALF_MAPSIZE ||
-                   om_addr.y > map_origin.y + HALF_MAPSIZE );
+        std::string quad_data = serialize_quad( om_addr, submaps_to_delete,
+                                                delete_after_save || zlev_del ||
+                                                om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
+                                                om_addr.x > map_origin.x + HALF_MAPSIZE ||
+                                                om_addr.y > map_origin.y + HALF_MAPSIZE );
         num_saved_submaps += 4;
+        if( quad_data.empty() ) {
+            continue;
+        }
+        if( use_segments ) {
+            segment_quads[segment_addr][om_addr] = std::move( quad_data );
+            continue;
+        }
+        // Don't create the directory if it would be empty
+        assure_dir_exist( dirname );
+        writer.write( quad_path, std::move( quad_data ) );
+    }
+    for( auto &elem : segment_quads ) {
+        const tripoint &segment_addr = elem.first;
+        const std::string dirname = string_format( "%s/%d.%d.%d", map_directory, segment_addr.x,
+                                    segment_addr.y, segment_addr.z );
+        map_segment_file *segment = get_segment_file( segment_addr );
+        if( segment != nullptr ) {
+            try {
+                file_patch patch = segment->serialize( elem.second );
+                // Quad files take precedence when loading, so older ones must not linger. They
+                // are only removed once their content is in the segment file.
+                std::vector<std::string> quad_paths;
+                for( const auto &quad : elem.second ) {
+                    const tripoint &om_addr = quad.first;
+                    quad_paths.push_back( string_format( "%s/%d.%d.%d.map", dirname, om_addr.x,
+                                                         om_addr.y, om_addr.z ) );
+                }
+                if( patch.front().first == 0 ) {
+                    writer.write( segment->get_path(), std::move( patch.front().second ),
+                                  std::move( quad_paths ) );
+                } else {
+                    writer.update( segment->get_path(), std::move( patch ), std::move( quad_paths ) );
+                }
+                continue;
+            } catch( const std::exception &err ) {
+                debugmsg( "Failed to save into %s: %s", segment->get_path(), err.what() );
+                // The offset table may not match the file anymore.
+                segment_files.erase( segment_addr );
+            }
+        }
+        // Quad files take precedence when loading, so nothing is lost by falling back to them.
+        assure_dir_exist( dirname );
+        for( auto &quad : elem.second ) {
+            const tripoint &om_addr = quad.first;
+            writer.write( string_format( "%s/%d.%d.%d.map", dirname, om_addr.x, om_addr.y, om_addr.z ),
+                          std::move( quad.second ) );
+        }
     }
     for( auto &elem : submaps_to_delete ) {
         remove_submap( elem );
     }
 }
 
-void mapbuffer::save_quad( const std::string &dirname, const std::string &filename,
-                           const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                           bool delete_after_save )
+map_segment_file *mapbuffer::get_segment_file( const tripoint &segment_addr )
+{
+    const std::string path = string_format( "%s/maps/%d.%d.%d.seg", g->get_world_base_save_path(),
+                                            segment_addr.x, segment_addr.y, segment_addr.z );
+    // The offset table must match the file, so the last write has to be finished. The content
+    // not replaced by the next save may also be read from it.
+    background_writer &writer = get_save_writer();
+    writer.wait_for( path );
+    auto iter = segment_files.find( segment_addr );
+    if( iter != segment_files.end() && writer.take_failure( path ) ) {
+        // The table already includes what failed to be written, the file has the old one.
+        segment_files.erase( iter );
+        iter = segment_files.end();
+    }
+    if( iter == segment_files.end() ) {
+        map_segment_file segment( path );
+        try {
+            segment.load_index();
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to read the offset table of %s: %s", path, err.what() );
+            return nullptr;
+        }
+        iter = segment_files.emplace( segment_addr, std::move( segment ) ).first;
+    }
+    return &iter->second;
+}
+
+void mapbuffer::convert_map_files( const bool to_segments )
+{
+    const std::string map_directory = g->get_world_base_save_path() + "/maps";
+    // This works on the files directly, so they must all be written.
+    get_save_writer().flush();
+    segment_files.clear();
+    if( to_segments ) {
+        // Paths of the quad files by segment and quad, their content is read one segment at a time.
+        std::map<tripoint, std::map<tripoint, std::string>> segment_quad_paths;
+        for( const std::string &quad_path : get_files_from_path( ".map", map_directory, true, true ) ) {
+            tripoint om_addr;
+            const std::string filename = quad_path.substr( quad_path.find_last_of( "/\\" ) + 1 );
+            if( sscanf( filename.c_str(), "%d.%d.%d.map", &om_addr.x, &om_addr.y, &om_addr.z ) != 3 ) {
+                debugmsg( "unexpected map file %s", quad_path );
+                continue;
+            }
+            segment_quad_paths[omt_to_seg_copy( om_addr )][om_addr] = quad_path;
+        }
+        std::set<std::string> dirnames;
+        for( const auto &elem : segment_quad_paths ) {
+            std::map<tripoint, std::string> quads;
+            for( const auto &quad : elem.second ) {
+                std::string quad_data;
+                const bool read = read_from_file( quad.second, [&]( std::istream & fin ) {
+                    quad_data.assign( std::istreambuf_iterator<char>( fin ),
+                                      std::istreambuf_iterator<char>() );
+                } );
+                // A quad that can not be read keeps its file, which still takes precedence.
+                if( read ) {
+                    quads[quad.first] = std::move( quad_data );
+                }
+            }
+            map_segment_file *segment = get_segment_file( elem.first );
+            if( quads.empty() || segment == nullptr ) {
+                continue;
+            }
+            try {
+                segment->write( quads );
+            } catch( const std::exception &err ) {
+                debugmsg( "Failed to write %s: %s", segment->get_path(), err.what() );
+                continue;
+            }
+            for( const auto &quad : quads ) {
+                const std::string &quad_path = elem.second.at( quad.first );
+                remove_file( quad_path );
+                dirnames.insert( quad_path.substr( 0, quad_path.find_last_of( "/\\" ) ) );
+            }
+            // Only one segment is kept in memory.
+            segment_files.erase( elem.first );
+        }
+        for( const std::string &dirname : dirnames ) {
+            // Fails for directories that still contain quad files that could not be converted.
+            if( dirname != map_directory ) {
+                remove_directory( dirname );
+            }
+        }
+    } else {
+        for( const std::string &segment_path : get_files_from_path( ".seg", map_directory, false,
+                true ) ) {
+            try {
+                map_segment_file segment( segment_path );
+                segment.load_index();
+                for( const auto &quad : segment.read_all() ) {
+                    const tripoint &om_addr = quad.first;
+                    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+                    const std::string dirname = string_format( "%s/%d.%d.%d", map_directory,
+                                                segment_addr.x, segment_addr.y, segment_addr.z );
+                    const std::string quad_path = string_format( "%s/%d.%d.%d.map", dirname, om_addr.x,
+                                                  om_addr.y, om_addr.z );
+                    if( file_exist( quad_path ) ) {
+                        // Quad files take precedence when loading, so this one is more recent.
+                        continue;
+                    }
+                    assure_dir_exist( dirname );
+                    write_to_file( quad_path, [&]( std::ostream & fout ) {
+                        fout << quad.second;
+                    } );
+                }
+            } catch( const std::exception &err ) {
+                // The segment file is kept, so nothing is lost.
+                debugmsg( "Failed to convert %s: %s", segment_path, err.what() );
+                continue;
+            }
+            remove_file( segment_path );
+        }
+    }
+    segment_files.clear();
+}
+
+std::string mapbuffer::serialize_quad( const tripoint &om_addr,
+                                      std::list<tripoint> &submaps_to_delete, bool delete_after_save )
 {
     std::vector<point> offsets;
     std::vector<tripoint> submap_addrs;
@@ -191,12 +365,11 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
             }
         }
 
-        return;
+        return std::string();
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname );
-    write_to_file( filename, [&]( std::ostream & fout ) {
+    std::ostringstream fout;
+    {
         JsonOut jsout( fout );
         jsout.start_array();
         for( auto &submap_addr : submap_addrs ) {
@@ -221,6 +394,7 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
             jsout.write( submap_addr.z );
             jsout.end_array();
 
+            sm->release_empty_tiles();
             sm->store( jsout );
 
             jsout.end_object();
@@ -231,7 +405,8 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         }
 
         jsout.end_array();
-    } );
+    }
+    return fout.str();
 }
 
 // We're reading in way too many entities here to mess around with creating sub-objects and
@@ -246,10 +421,33 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
     const std::string quad_path = string_format( "%s/%d.%d.%d.map", dirname, om_addr.x, om_addr.y,
                                   om_addr.z );
 
+    // The quad or its segment may still be written (or removed) by the last save.
+    background_writer &writer = get_save_writer();
+    writer.wait_for( quad_path );
+    writer.wait_for( string_format( "%s/maps/%d.%d.%d.seg", g->get_world_base_save_path(),
+                                    segment_addr.x, segment_addr.y, segment_addr.z ) );
+
     using namespace std::placeholders;
+    // A quad file takes precedence, it is removed when the quad gets saved into a segment file.
     if( !read_from_file_optional_json( quad_path, std::bind( &mapbuffer::deserialize, this, _1 ) ) ) {
-        // If it doesn't exist, trigger generating it.
-        return nullptr;
+        const map_segment_file *segment = get_segment_file( segment_addr );
+        if( segment == nullptr ) {
+            return nullptr;
+        }
+        try {
+            const cata::optional<std::string> quad_data = segment->read( om_addr );
+            if( !quad_data ) {
+                // If it doesn't exist, trigger generating it.
+                return nullptr;
+            }
+            std::istringstream fin( *quad_data );
+            JsonIn jsin( fin );
+            deserialize( jsin );
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to read quad %d,%d,%d from %s: %s", om_addr.x, om_addr.y, om_addr.z,
+                      segment->get_path(), err.what() );
+            return nullptr;
+        }
     }
     if( submaps.count( p ) == 0 ) {
         debugmsg( "file %s did not contain the expected submap %d,%d,%d",
@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 
+#include "map_segment.h"
 #include "point.h"
 
 class submap;
@@ -22,6 +23,8 @@ class mapbuffer
         ~mapbuffer();
 
         /** Store all submaps in this instance into savefiles.
+         * The submaps are serialized right away, the files are written in the background
+         * (see @ref get_save_writer).
          * @param delete_after_save If true, the saved submaps are removed
          * from the mapbuffer (and deleted).
          **/
@@ -57,6 +60,13 @@ class mapbuffer
         submap *lookup_submap( int x, int y, int z );
         submap *lookup_submap( const tripoint &p );
 
+        /**
+         * Converts all saved quads of the current world into the other storage layout: into
+         * one file per map segment if @p to_segments is true, into one file per quad otherwise.
+         * Only affects files, buffered submaps are saved according to the world options.
+         */
+        void convert_map_files( bool to_segments );
+
     private:
         using submap_map_t = std::map<tripoint, submap *>;
 
@@ -74,10 +84,19 @@ class mapbuffer
         void remove_submap( tripoint addr );
         submap *unserialize_submaps( const tripoint &p );
         void deserialize( JsonIn &jsin );
-        void save_quad( const std::string &dirname, const std::string &filename,
-                        const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                        bool delete_after_save );
+        /**
+         * Serializes the submap quad at @p om_addr. Returns an empty string if the quad needs
+         * not be saved because regenerating it is faster than loading it.
+         */
+        std::string serialize_quad( const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
+                                    bool delete_after_save );
+        /**
+         * Returns the segment file for the segment (its offset table is loaded on first use).
+         * Returns nullptr if the file exists but its offset table can not be read.
+         */
+        map_segment_file *get_segment_file( const tripoint &segment_addr );
         submap_map_t submaps;
+        std::map<tripoint, map_segment_file> segment_files;
 };
 
 extern mapbuffer MAPBUFFER;
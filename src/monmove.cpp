@@ -8,6 +8,8 @@
 #include <memory>
 #include <ostream>
 #include <list>
+#include <map>
+#include <set>
 
 #include "avatar.h"
 #include "bionics.h"
@@ -33,6 +35,7 @@
 #include "vehicle.h"
 #include "cata_utility.h"
 #include "game_constants.h"
+#include "hash_utils.h"
 #include "mattack_common.h"
 #include "pathfinding.h"
 #include "player.h"
@@ -227,6 +230,13 @@ void monster::wander_to( const tripoint &p, int f )
     wandf = f;
 }
 
+// The faction the monster is listed under in Creature_tracker::factions.
+static mfaction_id tracked_faction( const monster &mon )
+{
+    static const mfaction_str_id playerfaction( "player" );
+    return mon.friendly == 0 ? mon.faction : playerfaction.id();
+}
+
 float monster::rate_target( Creature &c, float best, bool smart ) const
 {
     const int d = rl_dist( pos(), c.pos() );
@@ -239,7 +249,7 @@ float monster::rate_target( Creature &c, float best, bool smart ) const
         return INT_MAX;
     }
 
-    if( !sees( c ) ) {
+    if( !g->critter_tracker->sees_this_turn( *this, c ) ) {
         return INT_MAX;
     }
 
@@ -280,12 +290,19 @@ void monster::plan()
     const int angers_cub_threatened = type->has_anger_trigger( mon_trigger::PLAYER_NEAR_BABY ) ? 8 : 0;
     const int fears_hostile_near = type->has_fear_trigger( mon_trigger::HOSTILE_CLOSE ) ? 5 : 0;
 
+    // Without smart planning rate_target only accepts creatures closer than dist, and
+    // nothing further away than the sight range (or adjacent) can be seen at all.
+    const auto rating_radius = [&]() {
+        const int sight_limit = std::max( max_sight_range, 1 );
+        return dist > sight_limit ? sight_limit : static_cast<int>( std::ceil( dist ) ) - 1;
+    };
+
     bool group_morale = has_flag( MF_GROUP_MORALE ) && morale < type->morale;
     bool swarms = has_flag( MF_SWARMS );
     auto mood = attitude();
 
     // If we can see the player, move toward them or flee, simpleminded animals are too dumb to follow the player.
-    if( friendly == 0 && sees( g->u ) && !has_flag( MF_PET_WONT_FOLLOW ) ) {
+    if( friendly == 0 && g->critter_tracker->sees_this_turn( *this, g->u ) && !has_flag( MF_PET_WONT_FOLLOW ) ) {
         dist = rate_target( g->u, dist, smart_planning );
         fleeing = fleeing || is_fleeing( g->u );
         target = &g->u;
@@ -323,7 +340,7 @@ void monster::plan()
             }
         }
     } else if( friendly != 0 && !docile ) {
-        for( monster &tmp : g->all_monsters() ) {
+        const auto consider_hostile = [&]( monster & tmp ) {
             if( tmp.friendly == 0 ) {
                 float rating = rate_target( tmp, dist, smart_planning );
                 if( rating < dist ) {
@@ -331,6 +348,17 @@ void monster::plan()
                     dist = rating;
                 }
             }
+        };
+        if( smart_planning ) {
+            // The rating is not a distance, so there is no radius to limit the search to.
+            for( monster &tmp : g->all_monsters() ) {
+                consider_hostile( tmp );
+            }
+        } else {
+            // rate_target rejects anything at or beyond the current best distance.
+            for( monster *tmp : g->critter_tracker->find_in_radius( pos(), max_sight_range - 1 ) ) {
+                consider_hostile( *tmp );
+            }
         }
     }
 
@@ -382,28 +410,48 @@ void monster::plan()
 
     fleeing = fleeing || ( mood == MATT_FLEE );
     if( friendly == 0 ) {
-        for( const auto &fac : factions ) {
-            auto faction_att = faction.obj().attitude( fac.first );
-            if( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY ) {
-                continue;
+        const auto consider_hostile = [&]( monster & mon ) {
+            float rating = rate_target( mon, dist, smart_planning );
+            if( rating < dist ) {
+                target = &mon;
+                dist = rating;
             }
-
-            for( const std::weak_ptr<monster> &weak : fac.second ) {
-                const std::shared_ptr<monster> shared = weak.lock();
-                if( !shared ) {
+            if( rating <= 5 ) {
+                anger += angers_hostile_near;
+                morale -= fears_hostile_near;
+            }
+        };
+        const auto is_hostile_faction = [this]( const mfaction_id & fac ) {
+            auto faction_att = faction.obj().attitude( fac );
+            return faction_att != MFA_NEUTRAL && faction_att != MFA_FRIENDLY;
+        };
+        if( smart_planning ) {
+            for( const auto &fac : factions ) {
+                if( !is_hostile_faction( fac.first ) ) {
                     continue;
                 }
-                monster &mon = *shared;
-                float rating = rate_target( mon, dist, smart_planning );
-                if( rating < dist ) {
-                    target = &mon;
-                    dist = rating;
-                }
-                if( rating <= 5 ) {
-                    anger += angers_hostile_near;
-                    morale -= fears_hostile_near;
+
+                for( const std::weak_ptr<monster> &weak : fac.second ) {
+                    const std::shared_ptr<monster> shared = weak.lock();
+                    if( shared ) {
+                        consider_hostile( *shared );
+                    }
                 }
             }
+        } else {
+            // Attitudes are looked up once per faction, not once per monster.
+            std::map<mfaction_id, bool> hostile_factions;
+            for( const auto &fac : factions ) {
+                hostile_factions.emplace( fac.first, is_hostile_faction( fac.first ) );
+            }
+            // dist only ever shrinks here, so the radius stays large enough.
+            for( monster *mon : g->critter_tracker->find_in_radius( pos(), rating_radius(),
+            [&hostile_factions]( const monster & mon ) {
+            const auto iter = hostile_factions.find( tracked_faction( mon ) );
+                return iter != hostile_factions.end() && iter->second;
+            } ) ) {
+                consider_hostile( *mon );
+            }
         }
     }
 
@@ -420,12 +468,22 @@ void monster::plan()
     }
     swarms = swarms && target == nullptr; // Only swarm if we have no target
     if( group_morale || swarms ) {
-        for( const std::weak_ptr<monster> &weak : myfaction_iter->second ) {
-            const std::shared_ptr<monster> shared = weak.lock();
-            if( !shared ) {
-                continue;
+        std::vector<monster *> allies;
+        if( smart_planning ) {
+            for( const std::weak_ptr<monster> &weak : myfaction_iter->second ) {
+                const std::shared_ptr<monster> shared = weak.lock();
+                if( shared ) {
+                    allies.push_back( shared.get() );
+                }
             }
-            monster &mon = *shared;
+        } else {
+            allies = g->critter_tracker->find_in_radius( pos(), rating_radius(),
+            [&actual_faction]( const monster & mon ) {
+                return tracked_faction( mon ) == actual_faction;
+            } );
+        }
+        for( monster *ally : allies ) {
+            monster &mon = *ally;
             float rating = rate_target( mon, dist, smart_planning );
             if( group_morale && rating <= 10 ) {
                 morale += 10 - rating;
@@ -733,7 +791,13 @@ void monster::move()
         if( pf_settings.max_dist >= rl_dist( pos(), goal ) &&
             ( path.empty() || rl_dist( pos(), path.front() ) >= 2 || path.back() != goal ) ) {
             // We need a new path
-            path = g->m.route( pos(), goal, pf_settings, get_path_avoid() );
+            const std::set<tripoint> avoid = get_path_avoid();
+            if( avoid.empty() ) {
+                // Hordes chasing the same target share the search
+                path = g->m.route_shared( pos(), goal, pf_settings );
+            } else {
+                path = g->m.route( pos(), goal, pf_settings, avoid );
+            }
         }
 
         // Try to respect old paths, even if we can't pathfind at the moment
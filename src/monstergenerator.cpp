@@ -196,6 +196,13 @@ bool string_id<mtype>::is_valid() const
     return MonsterGenerator::generator().mon_templates->is_valid( *this );
 }
 
+/** @relates string_id */
+template<>
+int_id<mtype> string_id<mtype>::id() const
+{
+    return MonsterGenerator::generator().mon_templates->convert( *this, int_id<mtype>( 0 ) );
+}
+
 /** @relates string_id */
 template<>
 const species_type &string_id<species_type>::obj() const
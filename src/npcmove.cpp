@@ -2130,7 +2130,8 @@ bool npc::update_path( const tripoint &p, const bool no_bashing, bool force )
         }
     }
 
-    auto new_path = g->m.route( pos(), p, get_pathfinding_settings( no_bashing ), get_path_avoid() );
+    auto new_path = g->m.route_hierarchical( pos(), p, get_pathfinding_settings( no_bashing ),
+                    get_path_avoid() );
     if( new_path.empty() ) {
         if( !ai_cache.sound_alerts.empty() ) {
             ai_cache.sound_alerts.erase( ai_cache.sound_alerts.begin() );
@@ -4028,7 +4029,7 @@ void npc::go_to_omt_destination()
             }
         }
     }
-    path = g->m.route( pos(), centre_sub, get_pathfinding_settings(), get_path_avoid() );
+    path = g->m.route_hierarchical( pos(), centre_sub, get_pathfinding_settings(), get_path_avoid() );
     add_msg( m_debug, "%s going (%d,%d,%d)->(%d,%d,%d)", name,
              omt_pos.x, omt_pos.y, omt_pos.z, goal.x, goal.y, goal.z );
 
@@ -15,6 +15,7 @@
 #include "catacharset.h"
 #include "color.h"
 #include "common_types.h"
+#include "enums.h"
 #include "int_id.h"
 #include "point.h"
 #include "string_id.h"
@@ -34,6 +35,12 @@ class overmap_connection;
 class overmap_special_batch;
 class overmap_special;
 
+namespace data_cache
+{
+class reader;
+class writer;
+} // namespace data_cache
+
 using overmap_special_id = string_id<overmap_special>;
 
 const overmap_land_use_code_id land_use_code_forest( "forest" );
@@ -466,6 +473,11 @@ void finalize();
 void reset();
 
 const std::vector<oter_t> &get_all();
+/**
+ * Returns the ids of all overmap terrains that match @p type according to @p match_type,
+ * see @ref is_ot_match. The result is kept until the terrains are reset.
+ */
+const std::vector<oter_id> &find_matches( const std::string &type, ot_match_type match_type );
 
 } // namespace overmap_terrains
 
@@ -476,6 +488,9 @@ void load( JsonObject &jo, const std::string &src );
 void finalize();
 void check_consistency();
 void reset();
+/** Store and restore the finalized codes, see @ref data_cache. */
+void save_cache( data_cache::writer &out );
+void load_cache( data_cache::reader &in );
 
 const std::vector<overmap_land_use_code> &get_all();
 
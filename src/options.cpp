@@ -1882,6 +1882,16 @@ void options_manager::add_options_debug()
 
     get_option( "FOV_3D_Z_RANGE" ).setPrerequisite( "FOV_3D" );
 
+    add( "WORKER_THREADS", "debug", translate_marker( "Worker threads" ),
+         translate_marker( "How many extra threads are used to build the map caches and the lightmap.  Mostly helps in z-level mode and with many light sources.  0 does all the work on the main thread." ),
+         0, 16, 0
+       );
+
+    add( "DATA_CACHE", "debug", translate_marker( "Cache game data" ),
+         translate_marker( "If true, some types of game data are stored in a cache after loading them, and loaded from there as long as the game version and the data files stay the same.  Speeds up starting the game, costs disk space." ),
+         false
+       );
+
     add( "ENCODING_CONV", "debug", translate_marker( "Experimental path name encoding conversion" ),
          translate_marker( "If true, file path names are going to be transcoded from system encoding to UTF-8 when reading and will be transcoded back when writing.  Mainly for CJK Windows users." ),
          true
@@ -2054,6 +2064,13 @@ void options_manager::add_options_world_default()
     { { "any", translate_marker( "Any" ) }, { "multi_pool", translate_marker( "Multi-pool only" ) }, { "no_freeform", translate_marker( "No freeform" ) } },
     "any"
        );
+
+    mOptionsSort["world_default"]++;
+
+    add( "SEGMENTED_MAP_FILES", "world_default", translate_marker( "Store maps in segment files" ),
+         translate_marker( "If true, saved map quads are stored in one file per map segment instead of one file per quad.  Quads saved the other way are still loaded and converted when saved again." ),
+         false
+       );
 }
 
 void options_manager::add_options_android()
@@ -12,10 +12,13 @@
 #include <exception>
 #include <unordered_set>
 #include <set>
+#include <sstream>
 
+#include "background_writer.h"
 #include "catacharset.h"
 #include "cata_utility.h"
 #include "coordinate_conversions.h"
+#include "data_cache.h"
 #include "debug.h"
 #include "flood_fill.h"
 #include "game.h"
@@ -179,6 +182,8 @@ generic_factory<overmap_land_use_code> land_use_codes( "overmap land use codes"
 generic_factory<oter_type_t> terrain_types( "overmap terrain type" );
 generic_factory<oter_t> terrains( "overmap terrain" );
 generic_factory<overmap_special> specials( "overmap special" );
+// Results of overmap_terrains::find_matches.
+std::map<std::pair<std::string, ot_match_type>, std::vector<oter_id>> terrain_matches;
 
 } // namespace
 
@@ -419,6 +424,35 @@ void overmap_land_use_codes::reset()
     land_use_codes.reset();
 }
 
+void overmap_land_use_codes::save_cache( data_cache::writer &out )
+{
+    const std::vector<overmap_land_use_code> &all = land_use_codes.get_all();
+    out.write_uint( all.size(), 4 );
+    for( const overmap_land_use_code &code : all ) {
+        out.write_string( code.id.str() );
+        out.write_int( code.land_use_code );
+        out.write_string( code.name );
+        out.write_string( code.detailed_definition );
+        out.write_uint( code.symbol, 4 );
+        out.write_string( string_from_color( code.color ) );
+    }
+}
+
+void overmap_land_use_codes::load_cache( data_cache::reader &in )
+{
+    for( uint64_t count = in.read_uint( 4 ); count > 0; count-- ) {
+        overmap_land_use_code code;
+        code.id = overmap_land_use_code_id( in.read_string() );
+        code.land_use_code = in.read_int();
+        code.name = in.read_string();
+        code.detailed_definition = in.read_string();
+        code.symbol = in.read_uint( 4 );
+        code.color = color_from_string( in.read_string() );
+        code.was_loaded = true;
+        land_use_codes.insert( code );
+    }
+}
+
 const std::vector<overmap_land_use_code> &overmap_land_use_codes::get_all()
 {
     return land_use_codes.get_all();
@@ -873,6 +907,7 @@ void overmap_terrains::reset()
 {
     terrain_types.reset();
     terrains.reset();
+    terrain_matches.clear();
 }
 
 const std::vector<oter_t> &overmap_terrains::get_all()
@@ -880,6 +915,24 @@ const std::vector<oter_t> &overmap_terrains::get_all()
     return terrains.get_all();
 }
 
+const std::vector<oter_id> &overmap_terrains::find_matches( const std::string &type,
+        const ot_match_type match_type )
+{
+    const auto key = std::make_pair( type, match_type );
+    const auto iter = terrain_matches.find( key );
+    if( iter != terrain_matches.end() ) {
+        return iter->second;
+    }
+    std::vector<oter_id> &result = terrain_matches[key];
+    for( const oter_t &ter : terrains.get_all() ) {
+        const oter_id id = ter.id.id();
+        if( is_ot_match( type, id, match_type ) ) {
+            result.push_back( id );
+        }
+    }
+    return result;
+}
+
 bool overmap_special_terrain::can_be_placed_on( const oter_id &oter ) const
 {
     return std::any_of( locations.begin(), locations.end(),
@@ -1171,6 +1224,7 @@ void overmap::init_layers()
             }
         }
     }
+    ter_locations.clear();
 }
 
 void overmap::ter_set( const tripoint &p, const oter_id &id )
@@ -1180,7 +1234,39 @@ void overmap::ter_set( const tripoint &p, const oter_id &id )
         return;
     }
 
-    layer[p.z + OVERMAP_DEPTH].terrain[p.x][p.y] = id;
+    oter_id &current = layer[p.z + OVERMAP_DEPTH].terrain[p.x][p.y];
+    if( !ter_locations.empty() && current != id ) {
+        const auto old_index = ter_locations.find( current );
+        if( old_index != ter_locations.end() ) {
+            old_index->second.remove( p );
+        }
+        const auto new_index = ter_locations.find( id );
+        if( new_index != ter_locations.end() ) {
+            new_index->second.add( p );
+        }
+    }
+    current = id;
+}
+
+void overmap::ter_location_index::add( const tripoint &p )
+{
+    slots[p] = locations.size();
+    locations.push_back( p );
+}
+
+void overmap::ter_location_index::remove( const tripoint &p )
+{
+    const auto iter = slots.find( p );
+    if( iter == slots.end() ) {
+        return;
+    }
+    const size_t slot = iter->second;
+    slots.erase( iter );
+    if( slot + 1 != locations.size() ) {
+        locations[slot] = locations.back();
+        slots[locations[slot]] = slot;
+    }
+    locations.pop_back();
 }
 
 const oter_id &overmap::ter( const tripoint &p ) const
@@ -1193,6 +1279,45 @@ const oter_id &overmap::ter( const tripoint &p ) const
     return layer[p.z + OVERMAP_DEPTH].terrain[p.x][p.y];
 }
 
+std::vector<const std::vector<tripoint> *> overmap::find_ter_locations( const std::string &type,
+        const ot_match_type match_type ) const
+{
+    const std::vector<oter_id> &matches = overmap_terrains::find_matches( type, match_type );
+
+    // The ids without an index yet get one from a single pass over the layers.
+    std::vector<bool> missing( overmap_terrains::get_all().size(), false );
+    bool any_missing = false;
+    for( const oter_id &id : matches ) {
+        if( ter_locations.count( id ) == 0 ) {
+            ter_locations[id];
+            missing[id.to_i()] = true;
+            any_missing = true;
+        }
+    }
+    if( any_missing ) {
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+            const map_layer &l = layer[z + OVERMAP_DEPTH];
+            for( int y = 0; y < OMAPY; y++ ) {
+                for( int x = 0; x < OMAPX; x++ ) {
+                    const oter_id &id = l.terrain[x][y];
+                    if( missing[id.to_i()] ) {
+                        ter_locations[id].add( tripoint( x, y, z ) );
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<const std::vector<tripoint> *> result;
+    for( const oter_id &id : matches ) {
+        const std::vector<tripoint> &locations = ter_locations[id].locations;
+        if( !locations.empty() ) {
+            result.push_back( &locations );
+        }
+    }
+    return result;
+}
+
 bool &overmap::seen( const tripoint &p )
 {
     if( !inbounds( p ) ) {
@@ -4290,10 +4415,12 @@ void overmap::place_radios()
 void overmap::open( overmap_special_batch &enabled_specials )
 {
     const std::string terfilename = overmapbuffer::terrain_filename( loc );
+    const std::string plrfilename = overmapbuffer::player_filename( loc );
+    get_save_writer().wait_for( terfilename );
+    get_save_writer().wait_for( plrfilename );
 
     using namespace std::placeholders;
     if( read_from_file_optional( terfilename, std::bind( &overmap::unserialize, this, _1 ) ) ) {
-        const std::string plrfilename = overmapbuffer::player_filename( loc );
         read_from_file_optional( plrfilename, std::bind( &overmap::unserialize_view, this, _1 ) );
     } else { // No map exists!  Prepare neighbors, and generate one.
         std::vector<const overmap *> pointers;
@@ -4311,16 +4438,17 @@ void overmap::open( overmap_special_batch &enabled_specials )
     }
 }
 
-// Note: this may throw io errors from std::ofstream
 void overmap::save() const
 {
-    write_to_file( overmapbuffer::player_filename( loc ), [&]( std::ostream & stream ) {
-        serialize_view( stream );
-    } );
+    // Only serializing happens here, the files are written in the background.
+    background_writer &writer = get_save_writer();
+    std::ostringstream view;
+    serialize_view( view );
+    writer.write( overmapbuffer::player_filename( loc ), view.str() );
 
-    write_to_file( overmapbuffer::terrain_filename( loc ), [&]( std::ostream & stream ) {
-        serialize( stream );
-    } );
+    std::ostringstream terrain;
+    serialize( terrain );
+    writer.write( overmapbuffer::terrain_filename( loc ), terrain.str() );
 }
 
 void overmap::add_mon_group( const mongroup &group )
@@ -172,6 +172,7 @@ class overmap
             return loc;
         }
 
+        /** Serializes the overmap, the files are written in the background, see @ref get_save_writer. */
         void save() const;
 
         /**
@@ -190,6 +191,16 @@ class overmap
 
         void ter_set( const tripoint &p, const oter_id &id );
         const oter_id &ter( const tripoint &p ) const;
+        /**
+         * Returns the (local) overmap terrain coordinates of every terrain in this overmap that
+         * matches @p type according to @p match_type (see @ref is_ot_match), as one list per
+         * matching terrain id. The lists are owned by an index of terrain locations that only
+         * covers the terrain ids searched for so far. It is built when an id is first searched
+         * for and kept up to date by @ref ter_set, changing the terrain of this overmap
+         * invalidates the lists.
+         */
+        std::vector<const std::vector<tripoint> *> find_ter_locations( const std::string &type,
+                ot_match_type match_type ) const;
         bool &seen( const tripoint &p );
         bool seen( const tripoint &p ) const;
         bool &explored( const tripoint &p );
@@ -299,6 +310,18 @@ class overmap
         std::array<map_layer, OVERMAP_LAYERS> layer;
         std::unordered_map<tripoint, scent_trace> scents;
 
+        /** Local coordinates of one terrain id in @ref layer. */
+        struct ter_location_index {
+            std::vector<tripoint> locations;
+            /** Position of each location in @ref locations. */
+            std::unordered_map<tripoint, size_t> slots;
+
+            void add( const tripoint &p );
+            void remove( const tripoint &p );
+        };
+        /** Location index of the terrain ids searched for so far, see @ref find_ter_locations. */
+        mutable std::unordered_map<oter_id, ter_location_index> ter_locations;
+
         // Records the locations where a given overmap special was placed, which
         // can be used after placement to lookup whether a given location was created
         // as part of a special.
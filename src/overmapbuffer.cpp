@@ -7,8 +7,10 @@
 #include <iterator>
 #include <list>
 #include <map>
+#include <tuple>
 
 #include "avatar.h"
+#include "background_writer.h"
 #include "basecamp.h"
 #include "cata_utility.h"
 #include "coordinate_conversions.h"
@@ -189,7 +191,6 @@ void overmapbuffer::fix_npcs( overmap &new_overmap )
 void overmapbuffer::save()
 {
     for( auto &omp : overmaps ) {
-        // Note: this may throw io errors from std::ofstream
         omp.second->save();
     }
 }
@@ -249,7 +250,9 @@ overmap *overmapbuffer::get_existing( const point &p )
         // checked in a previous call of this function).
         return nullptr;
     }
-    if( file_exist( terrain_filename( p ) ) ) {
+    const std::string filename = terrain_filename( p );
+    get_save_writer().wait_for( filename );
+    if( file_exist( filename ) ) {
         // File exists, load it normally (the get function
         // indirectly call overmap::open to do so).
         return &get( p );
@@ -875,6 +878,75 @@ tripoint overmapbuffer::find_closest( const tripoint &origin, const std::string
                                    existing_overmaps_only, om_special );
     return find_closest( origin, params );
 }
+/**
+ * Overmap positions of all overmaps that overlap the square of the given radius around the
+ * origin (in overmap terrain coordinates), paired with the distance from the origin to the
+ * closest location of the overmap and sorted by it.
+ */
+static std::vector<std::pair<int, point>> overmaps_by_distance( const point &origin,
+                                       const int radius )
+{
+    std::vector<std::pair<int, point>> result;
+    const point om_min = omt_to_om_copy( origin - point( radius, radius ) );
+    const point om_max = omt_to_om_copy( origin + point( radius, radius ) );
+    for( int y = om_min.y; y <= om_max.y; y++ ) {
+        for( int x = om_min.x; x <= om_max.x; x++ ) {
+            const point omt_min = om_to_omt_copy( point( x, y ) );
+            const point closest( clamp( origin.x, omt_min.x, omt_min.x + OMAPX - 1 ),
+                                 clamp( origin.y, omt_min.y, omt_min.y + OMAPY - 1 ) );
+            result.emplace_back( square_dist( origin, closest ), point( x, y ) );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+/**
+ * Calls @p func with the global overmap terrain coordinates of every terrain of @p om that
+ * is within the given (inclusive, global) bounds and matches the type of @p params.
+ * Uses the terrain location index of the overmap, unless checking the terrain within the
+ * bounds directly is cheaper.
+ */
+static void for_each_ter_match( const overmap &om, const omt_find_params &params,
+                                const tripoint &min, const tripoint &max,
+                                const std::function<void( const tripoint & )> &func )
+{
+    const point om_origin = om_to_omt_copy( om.pos() );
+    const tripoint local_min( std::max( min.x - om_origin.x, 0 ), std::max( min.y - om_origin.y, 0 ),
+                              std::max( min.z, -OVERMAP_DEPTH ) );
+    const tripoint local_max( std::min( max.x - om_origin.x, OMAPX - 1 ),
+                              std::min( max.y - om_origin.y, OMAPY - 1 ), std::min( max.z, OVERMAP_HEIGHT ) );
+    if( local_min.x > local_max.x || local_min.y > local_max.y || local_min.z > local_max.z ) {
+        return;
+    }
+
+    const std::vector<const std::vector<tripoint> *> matches = om.find_ter_locations( params.type,
+            params.match_type );
+    size_t num_matches = 0;
+    for( const std::vector<tripoint> *locations : matches ) {
+        num_matches += locations->size();
+    }
+    const tripoint extent = local_max - local_min + tripoint( 1, 1, 1 );
+    if( static_cast<size_t>( extent.x * extent.y * extent.z ) < num_matches ) {
+        // Small search area, checking it directly is faster than going through the index.
+        for( const tripoint &local : tripoint_range( local_min, local_max ) ) {
+            if( is_ot_match( params.type, om.ter( local ), params.match_type ) ) {
+                func( tripoint( om_origin, 0 ) + local );
+            }
+        }
+        return;
+    }
+    for( const std::vector<tripoint> *locations : matches ) {
+        for( const tripoint &local : *locations ) {
+            if( local.x >= local_min.x && local.x <= local_max.x &&
+                local.y >= local_min.y && local.y <= local_max.y &&
+                local.z >= local_min.z && local.z <= local_max.z ) {
+                func( tripoint( om_origin, 0 ) + local );
+            }
+        }
+    }
+}
+
 tripoint overmapbuffer::find_closest( const tripoint &origin, const omt_find_params &params )
 {
     // Check the origin before searching adjacent tiles!
@@ -899,39 +971,39 @@ tripoint overmapbuffer::find_closest( const tripoint &origin, const omt_find_par
     // and each additional one expends the search to the next concentric circle of overmaps.
     int max = params.search_range ? params.search_range : OMAPX * 5;
     const int min_distance = std::max( 0, params.min_distance );
-    // expanding box
-    for( int dist = min_distance; dist <= max; dist++ ) {
-        // each edge length is 2*dist-2, because corners belong to one edge
-        // south is +y, north is -y
-        for( int i = min_distance * 2; i < dist * 2; i++ ) {
-            for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
-                //start at northwest, scan north edge
-                const tripoint n_loc( origin.x - dist + i, origin.y - dist, z );
-                if( is_findable_location( n_loc, params ) ) {
-                    return n_loc;
-                }
-
-                //start at southeast, scan south
-                const tripoint s_loc( origin.x + dist - i, origin.y + dist, z );
-                if( is_findable_location( s_loc, params ) ) {
-                    return s_loc;
-                }
-
-                //start at southwest, scan west
-                const tripoint w_loc( origin.x - dist, origin.y + dist - i, z );
-                if( is_findable_location( w_loc, params ) ) {
-                    return w_loc;
-                }
-
-                //start at northeast, scan east
-                const tripoint e_loc( origin.x + dist, origin.y - dist + i, z );
-                if( is_findable_location( e_loc, params ) ) {
-                    return e_loc;
-                }
-            }
+    const tripoint search_min( origin.x - max, origin.y - max, -OVERMAP_DEPTH );
+    const tripoint search_max( origin.x + max, origin.y + max, OVERMAP_HEIGHT );
+
+    // The distance is measured horizontally, ties are broken by the vertical distance and
+    // then the location itself to get the same result regardless of the order of the index.
+    tripoint best = overmap::invalid_tripoint;
+    int best_dist = INT_MAX;
+    int best_dz = INT_MAX;
+    for( const std::pair<int, point> &om_entry : overmaps_by_distance( origin.xy(), max ) ) {
+        if( om_entry.first > best_dist ) {
+            // Nothing in this and all further overmaps can be closer.
+            break;
+        }
+        const overmap *om = params.existing_only ? get_existing( om_entry.second ) :
+                            &get( om_entry.second );
+        if( om == nullptr ) {
+            continue;
         }
+        for_each_ter_match( *om, params, search_min, search_max, [&]( const tripoint & loc ) {
+            const int dist = square_dist( origin.xy(), loc.xy() );
+            const int dz = std::abs( loc.z - origin.z );
+            if( dist < min_distance || loc == origin ||
+                std::make_tuple( dist, dz, loc ) >= std::make_tuple( best_dist, best_dz, best ) ) {
+                return;
+            }
+            if( is_findable_location( loc, params ) ) {
+                best = loc;
+                best_dist = dist;
+                best_dz = dz;
+            }
+        } );
     }
-    return overmap::invalid_tripoint;
+    return best;
 }
 
 std::vector<tripoint> overmapbuffer::find_all( const tripoint &origin,
@@ -941,14 +1013,25 @@ std::vector<tripoint> overmapbuffer::find_all( const tripoint &origin,
     // dist == 0 means search a whole overmap diameter.
     const int dist = params.search_range ? params.search_range : OMAPX;
     const int min_distance = std::max( 0, params.min_distance );
-    for( const tripoint &search_loc : points_in_radius( origin, dist ) ) {
-        if( square_dist( origin, search_loc ) < min_distance ) {
+    const tripoint search_min( origin.x - dist, origin.y - dist, origin.z );
+    const tripoint search_max( origin.x + dist, origin.y + dist, origin.z );
+    for( const std::pair<int, point> &om_entry : overmaps_by_distance( origin.xy(), dist ) ) {
+        const overmap *om = params.existing_only ? get_existing( om_entry.second ) :
+                            &get( om_entry.second );
+        if( om == nullptr ) {
             continue;
         }
-        if( is_findable_location( search_loc, params ) ) {
-            result.push_back( search_loc );
-        }
+        for_each_ter_match( *om, params, search_min, search_max, [&]( const tripoint & loc ) {
+            if( square_dist( origin, loc ) >= min_distance && is_findable_location( loc, params ) ) {
+                result.push_back( loc );
+            }
+        } );
     }
+    // Closest first, the location itself only makes the order independent of the index.
+    std::sort( result.begin(), result.end(), [&origin]( const tripoint & lhs, const tripoint & rhs ) {
+        return std::make_tuple( square_dist( origin, lhs ), lhs ) <
+               std::make_tuple( square_dist( origin, rhs ), rhs );
+    } );
     return result;
 }
 std::vector<tripoint> overmapbuffer::find_all( const tripoint &origin, const std::string &type,
@@ -1,15 +1,21 @@
 #include "pathfinding.h"
 
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
 #include <queue>
 #include <set>
+#include <unordered_map>
 #include <array>
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "calendar.h"
 #include "cata_utility.h"
+#include "coordinate_conversions.h"
 #include "coordinates.h"
 #include "debug.h"
 #include "map.h"
@@ -24,6 +30,10 @@
 #include "type_id.h"
 #include "point.h"
 
+static constexpr pf_special non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP;
+
+constexpr int flow_field::unreachable;
+
 enum astar_state {
     ASL_NONE,
     ASL_OPEN,
@@ -37,42 +47,121 @@ constexpr int flat_index( const int x, const int y )
 }
 
 // Flattened 2D array representing a single z-level worth of pathfinding data
+// The layers are reused by all searches of a thread. Cells whose stamp differs from
+// the generation of the layer haven't been visited by the current search, so starting
+// a new search doesn't need to reset them.
 struct path_data_layer {
+    unsigned int generation = 0;
+    std::array< unsigned int, MAPSIZE_X *MAPSIZE_Y > stamp;
     // State is accessed way more often than all other values here
-    std::array< astar_state, MAPSIZE_X *MAPSIZE_Y > state;
+    std::array< astar_state, MAPSIZE_X *MAPSIZE_Y > states;
     std::array< int, MAPSIZE_X *MAPSIZE_Y > score;
     std::array< int, MAPSIZE_X *MAPSIZE_Y > gscore;
-    std::array< tripoint, MAPSIZE_X *MAPSIZE_Y > parent;
+    // Offset to the parent, see @ref encode_parent
+    std::array< int16_t, MAPSIZE_X *MAPSIZE_Y > parent;
 
-    void init( const point &min, const point &max ) {
-        for( int x = min.x; x <= max.x; x++ ) {
-            for( int y = min.y; y <= max.y; y++ ) {
-                const int ind = flat_index( x, y );
-                state[ind] = ASL_NONE; // Mark as unvisited
-            }
+    void start_search() {
+        if( ++generation == 0 ) {
+            stamp.fill( 0 );
+            generation = 1;
         }
     }
-};
 
-struct pathfinder {
-    point min;
-    point max;
-    pathfinder( int _minx, int _miny, int _maxx, int _maxy ) :
-        min( _minx, _miny ), max( _maxx, _maxy ) {
+    astar_state state( const int index ) const {
+        return stamp[index] == generation ? states[index] : ASL_NONE;
     }
 
-    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
-    open;
+    void set_state( const int index, const astar_state s ) {
+        stamp[index] = generation;
+        states[index] = s;
+    }
+};
+
+// Parents are at most an overmap tile away (stairs) and at most one z-level apart.
+static int16_t encode_parent( const tripoint &from, const tripoint &to )
+{
+    return static_cast<int16_t>( ( from.x - to.x + 32 ) + ( from.y - to.y + 32 ) * 64 +
+                                 ( from.z - to.z + 1 ) * 64 * 64 );
+}
+
+static tripoint decode_parent( const int16_t offset, const tripoint &to )
+{
+    return to + tripoint( offset % 64 - 32, offset / 64 % 64 - 32, offset / ( 64 * 64 ) - 1 );
+}
+
+// Priority queue for the small, integer scores of the search: scores below bucket_count
+// get a bucket each, the rare higher ones (huge penalties) go into a regular heap.
+class open_list
+{
+    public:
+        bool empty() const {
+            return size == 0 && overflow.empty();
+        }
+
+        void clear() {
+            for( ; lowest < bucket_count; lowest++ ) {
+                buckets[lowest].clear();
+            }
+            size = 0;
+            overflow = decltype( overflow )();
+        }
+
+        void push( const int score, const tripoint &p ) {
+            if( score >= bucket_count ) {
+                overflow.emplace( score, p );
+                return;
+            }
+            // Scores aren't monotonic, the heuristic is not consistent everywhere.
+            const int bucket = std::max( score, 0 );
+            buckets[bucket].push_back( p );
+            lowest = std::min( lowest, bucket );
+            size++;
+        }
+
+        tripoint pop() {
+            if( size == 0 ) {
+                const tripoint p = overflow.top().second;
+                overflow.pop();
+                return p;
+            }
+            while( buckets[lowest].empty() ) {
+                lowest++;
+            }
+            const tripoint p = buckets[lowest].back();
+            buckets[lowest].pop_back();
+            size--;
+            return p;
+        }
+
+    private:
+        static constexpr int bucket_count = 1024;
+        std::array< std::vector<tripoint>, bucket_count > buckets;
+        int lowest = bucket_count;
+        size_t size = 0;
+        std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
+        overflow;
+};
+
+struct pathfinder {
+    open_list open;
     std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
+    std::array< bool, OVERMAP_LAYERS > searched;
+
+    // Starts a new search, all points become unvisited.
+    void start() {
+        open.clear();
+        searched.fill( false );
+    }
 
     path_data_layer &get_layer( const int z ) {
         std::unique_ptr< path_data_layer > &ptr = path_data[z + OVERMAP_DEPTH];
-        if( ptr != nullptr ) {
-            return *ptr;
+        if( ptr == nullptr ) {
+            ptr = std::make_unique<path_data_layer>();
+        }
+        if( !searched[z + OVERMAP_DEPTH] ) {
+            ptr->start_search();
+            searched[z + OVERMAP_DEPTH] = true;
         }
-
-        ptr = std::make_unique<path_data_layer>();
-        ptr->init( min, max );
         return *ptr;
     }
 
@@ -81,36 +170,34 @@ struct pathfinder {
     }
 
     tripoint get_next() {
-        const auto pt = open.top();
-        open.pop();
-        return pt.second;
+        return open.pop();
     }
 
     void add_point( const int gscore, const int score, const tripoint &from, const tripoint &to ) {
         auto &layer = get_layer( to.z );
         const int index = flat_index( to.x, to.y );
-        if( ( layer.state[index] == ASL_OPEN && gscore >= layer.gscore[index] ) ||
-            layer.state[index] == ASL_CLOSED ) {
+        const astar_state state = layer.state( index );
+        if( ( state == ASL_OPEN && gscore >= layer.gscore[index] ) || state == ASL_CLOSED ) {
             return;
         }
 
-        layer.state [index] = ASL_OPEN;
+        layer.set_state( index, ASL_OPEN );
         layer.gscore[index] = gscore;
-        layer.parent[index] = from;
+        layer.parent[index] = encode_parent( from, to );
         layer.score [index] = score;
-        open.push( std::make_pair( score, to ) );
+        open.push( score, to );
     }
 
     void close_point( const tripoint &p ) {
         auto &layer = get_layer( p.z );
         const int index = flat_index( p.x, p.y );
-        layer.state[index] = ASL_CLOSED;
+        layer.set_state( index, ASL_CLOSED );
     }
 
     void unclose_point( const tripoint &p ) {
         auto &layer = get_layer( p.z );
         const int index = flat_index( p.x, p.y );
-        layer.state[index] = ASL_NONE;
+        layer.set_state( index, ASL_NONE );
     }
 };
 
@@ -177,6 +264,127 @@ bool is_disjoint( const Set1 &set1, const Set2 &set2 )
     return true;
 }
 
+pathfinding_step map::route_step( const tripoint &cur, const tripoint &p, const pf_special p_special,
+                                  const pathfinding_settings &settings ) const
+{
+    pathfinding_step step;
+    if( !( p_special & non_normal ) ) {
+        // Boring flat dirt - the most common case above the ground
+        step.cost = 2;
+        return step;
+    }
+
+    pathfinding_step closed;
+    closed.passable = false;
+    closed.closed = true;
+    pathfinding_step blocked;
+    blocked.passable = false;
+
+    if( settings.avoid_rough_terrain ) {
+        // Close all rough terrain tiles
+        return closed;
+    }
+
+    const int bash = settings.bash_strength;
+    const bool doors = settings.allow_open_doors;
+    int part = -1;
+    const maptile &tile = maptile_at_internal( p );
+    const auto &terrain = tile.get_ter_t();
+    const auto &furniture = tile.get_furn_t();
+    const vehicle *veh = veh_at_internal( p, part );
+
+    const int cost = move_cost_internal( furniture, terrain, veh, part );
+    // Don't calculate bash rating unless we intend to actually use it
+    const int rating = ( bash == 0 || cost != 0 ) ? -1 :
+                       bash_rating_internal( bash, furniture, terrain, false, veh, part );
+
+    if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
+        settings.climb_cost <= 0 ) {
+        return closed;
+    }
+
+    step.cost = cost;
+    if( cost == 0 ) {
+        if( settings.climb_cost > 0 && p_special & PF_CLIMBABLE ) {
+            // Climbing fences
+            step.cost += settings.climb_cost;
+        } else if( doors && ( terrain.open || furniture.open ) &&
+                   ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ||
+                     !is_outside( cur ) ) ) {
+            // Only try to open INSIDE doors from the inside
+            // To open and then move onto the tile
+            step.cost += 4;
+        } else if( veh != nullptr ) {
+            const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
+            part = vpobst ? vpobst->part_index() : -1;
+            int dummy = -1;
+            if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
+                ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
+                  veh_at_internal( cur, dummy ) == veh ) ) {
+                // Handle car doors, but don't try to path through curtains
+                step.cost += 10; // One turn to open, 4 to move there
+            } else if( part >= 0 && bash > 0 ) {
+                // Car obstacle that isn't a door
+                // TODO: Account for armor
+                int hp = veh->parts[part].hp();
+                if( hp / 20 > bash ) {
+                    // Threshold damage thing means we just can't bash this down
+                    return closed;
+                } else if( hp / 10 > bash ) {
+                    // Threshold damage thing means we will fail to deal damage pretty often
+                    hp *= 2;
+                }
+
+                step.cost += 2 * hp / bash + 8 + 4;
+            } else if( part >= 0 ) {
+                if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
+                    // Won't be openable, don't try from other sides
+                    return closed;
+                }
+
+                return blocked;
+            }
+        } else if( rating > 1 ) {
+            // Expected number of turns to bash it down, 1 turn to move there
+            // and 5 turns of penalty not to trash everything just because we can
+            step.cost += ( 20 / rating ) + 2 + 10;
+        } else if( rating == 1 ) {
+            // Desperate measures, avoid whenever possible
+            step.cost += 500;
+        } else {
+            // Unbashable and unopenable from here
+            if( !doors || !terrain.open || !furniture.open ) {
+                // Or anywhere else for that matter
+                return closed;
+            }
+
+            return blocked;
+        }
+    }
+
+    if( settings.avoid_traps && p_special & PF_TRAP ) {
+        const auto &ter_trp = terrain.trap.obj();
+        const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+        if( !trp.is_benign() ) {
+            // For now make them detect all traps
+            if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
+                // Special case - ledge in z-levels
+                // Warning: really expensive, needs a cache
+                if( valid_move( p, tripoint( p.xy(), p.z - 1 ), false, true ) ) {
+                    // Close p, because we won't be walking on it
+                    closed.ledge = true;
+                    return closed;
+                }
+            } else {
+                // Otherwise it's walkable
+                step.cost += 500;
+            }
+        }
+    }
+
+    return step;
+}
+
 std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                   const pathfinding_settings &settings,
                                   const std::set<tripoint> &pre_closed ) const
@@ -197,7 +405,6 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     }
     // First, check for a simple straight line on flat ground
     // Except when the line contains a pre-closed tile - we need to do regular pathing then
-    static const auto non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP;
     if( f.z == t.z ) {
         const auto line_path = line_to( f, t );
         const auto &pf_cache = get_pathfinding_cache_ref( f.z );
@@ -219,11 +426,6 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     }
 
     int max_length = settings.max_length;
-    int bash = settings.bash_strength;
-    int climb_cost = settings.climb_cost;
-    bool doors = settings.allow_open_doors;
-    bool trapavoid = settings.avoid_traps;
-    bool roughavoid = settings.avoid_rough_terrain;
 
     const int pad = 16;  // Should be much bigger - low value makes pathfinders dumb!
     int minx = std::min( f.x, t.x ) - pad;
@@ -235,7 +437,9 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     clip_to_bounds( minx, miny, minz );
     clip_to_bounds( maxx, maxy, maxz );
 
-    pathfinder pf( minx, miny, maxx, maxy );
+    // The workspace is big, so it's kept around instead of being allocated for every search.
+    static thread_local pathfinder pf;
+    pf.start();
     // Make NPCs not want to path through player
     // But don't make player pathing stop working
     for( const auto &p : pre_closed ) {
@@ -256,8 +460,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
         const int parent_index = flat_index( cur.x, cur.y );
         auto &layer = pf.get_layer( cur.z );
-        auto &cur_state = layer.state[parent_index];
-        if( cur_state == ASL_CLOSED ) {
+        if( layer.state( parent_index ) == ASL_CLOSED ) {
             continue;
         }
 
@@ -271,7 +474,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             break;
         }
 
-        cur_state = ASL_CLOSED;
+        layer.set_state( parent_index, ASL_CLOSED );
 
         const auto &pf_cache = get_pathfinding_cache_ref( cur.z );
         const auto cur_special = pf_cache.special[cur.x][cur.y];
@@ -290,135 +493,37 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 continue;
             }
 
-            if( layer.state[index] == ASL_CLOSED ) {
+            if( layer.state( index ) == ASL_CLOSED ) {
                 continue;
             }
 
             // Penalize for diagonals or the path will look "unnatural"
             int newg = layer.gscore[parent_index] + ( ( cur.x != p.x && cur.y != p.y ) ? 1 : 0 );
 
-            const auto p_special = pf_cache.special[p.x][p.y];
-            // TODO: De-uglify, de-huge-n
-            if( !( p_special & non_normal ) ) {
-                // Boring flat dirt - the most common case above the ground
-                newg += 2;
-            } else {
-                if( roughavoid ) {
-                    layer.state[index] = ASL_CLOSED; // Close all rough terrain tiles
-                    continue;
-                }
-
-                int part = -1;
-                const maptile &tile = maptile_at_internal( p );
-                const auto &terrain = tile.get_ter_t();
-                const auto &furniture = tile.get_furn_t();
-                const vehicle *veh = veh_at_internal( p, part );
-
-                const int cost = move_cost_internal( furniture, terrain, veh, part );
-                // Don't calculate bash rating unless we intend to actually use it
-                const int rating = ( bash == 0 || cost != 0 ) ? -1 :
-                                   bash_rating_internal( bash, furniture, terrain, false, veh, part );
-
-                if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
-                    climb_cost <= 0 ) {
-                    layer.state[index] = ASL_CLOSED; // Close it so that next time we won't try to calculate costs
-                    continue;
-                }
-
-                newg += cost;
-                if( cost == 0 ) {
-                    if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
-                        // Climbing fences
-                        newg += climb_cost;
-                    } else if( doors && ( terrain.open || furniture.open ) &&
-                               ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ||
-                                 !is_outside( cur ) ) ) {
-                        // Only try to open INSIDE doors from the inside
-                        // To open and then move onto the tile
-                        newg += 4;
-                    } else if( veh != nullptr ) {
-                        const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
-                        part = vpobst ? vpobst->part_index() : -1;
-                        int dummy = -1;
-                        if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
-                            ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
-                              veh_at_internal( cur, dummy ) == veh ) ) {
-                            // Handle car doors, but don't try to path through curtains
-                            newg += 10; // One turn to open, 4 to move there
-                        } else if( part >= 0 && bash > 0 ) {
-                            // Car obstacle that isn't a door
-                            // TODO: Account for armor
-                            int hp = veh->parts[part].hp();
-                            if( hp / 20 > bash ) {
-                                // Threshold damage thing means we just can't bash this down
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            } else if( hp / 10 > bash ) {
-                                // Threshold damage thing means we will fail to deal damage pretty often
-                                hp *= 2;
-                            }
-
-                            newg += 2 * hp / bash + 8 + 4;
-                        } else if( part >= 0 ) {
-                            if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
-                                // Won't be openable, don't try from other sides
-                                layer.state[index] = ASL_CLOSED;
-                            }
-
-                            continue;
-                        }
-                    } else if( rating > 1 ) {
-                        // Expected number of turns to bash it down, 1 turn to move there
-                        // and 5 turns of penalty not to trash everything just because we can
-                        newg += ( 20 / rating ) + 2 + 10;
-                    } else if( rating == 1 ) {
-                        // Desperate measures, avoid whenever possible
-                        newg += 500;
-                    } else {
-                        // Unbashable and unopenable from here
-                        if( !doors || !terrain.open || !furniture.open ) {
-                            // Or anywhere else for that matter
-                            layer.state[index] = ASL_CLOSED;
-                        }
-
-                        continue;
-                    }
-                }
-
-                if( trapavoid && p_special & PF_TRAP ) {
-                    const auto &ter_trp = terrain.trap.obj();
-                    const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
-                    if( !trp.is_benign() ) {
-                        // For now make them detect all traps
-                        if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
-                            // Special case - ledge in z-levels
-                            // Warning: really expensive, needs a cache
-                            if( valid_move( p, tripoint( p.xy(), p.z - 1 ), false, true ) ) {
-                                tripoint below( p.xy(), p.z - 1 );
-                                if( !has_flag( TFLAG_NO_FLOOR, below ) ) {
-                                    // Otherwise this would have been a huge fall
-                                    auto &layer = pf.get_layer( p.z - 1 );
-                                    // From cur, not p, because we won't be walking on air
-                                    pf.add_point( layer.gscore[parent_index] + 10,
-                                                  layer.score[parent_index] + 10 + 2 * rl_dist( below, t ),
-                                                  cur, below );
-                                }
-
-                                // Close p, because we won't be walking on it
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            }
-                        } else if( trapavoid ) {
-                            // Otherwise it's walkable
-                            newg += 500;
-                        }
-                    }
+            const pathfinding_step step = route_step( cur, p, pf_cache.special[p.x][p.y], settings );
+            if( step.ledge ) {
+                const tripoint below( p.xy(), p.z - 1 );
+                if( !has_flag( TFLAG_NO_FLOOR, below ) ) {
+                    // Otherwise this would have been a huge fall
+                    // From cur, not p, because we won't be walking on air
+                    pf.add_point( layer.gscore[parent_index] + 10,
+                                  layer.score[parent_index] + 10 + 2 * rl_dist( below, t ),
+                                  cur, below );
                 }
             }
+            if( step.closed ) {
+                // Close it so that next time we won't try to calculate costs
+                layer.set_state( index, ASL_CLOSED );
+                continue;
+            }
+            if( !step.passable ) {
+                continue;
+            }
+            newg += step.cost;
 
             // If not visited, add as open
             // If visited, add it only if we can do so with better score
-            if( layer.state[index] == ASL_NONE || newg < layer.gscore[index] ) {
+            if( layer.state( index ) == ASL_NONE || newg < layer.gscore[index] ) {
                 pf.add_point( newg, newg + 2 * rl_dist( p, t ), cur, p );
             }
         }
@@ -433,7 +538,6 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         if( settings.allow_climb_stairs && cur.z > minz && parent_terrain.has_flag( TFLAG_GOES_DOWN ) ) {
             tripoint dest( cur.xy(), cur.z - 1 );
             if( vertical_move_destination<TFLAG_GOES_UP>( *this, dest ) ) {
-                auto &layer = pf.get_layer( dest.z );
                 pf.add_point( layer.gscore[parent_index] + 2,
                               layer.score[parent_index] + 2 * rl_dist( dest, t ),
                               cur, dest );
@@ -442,7 +546,6 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         if( settings.allow_climb_stairs && cur.z < maxz && parent_terrain.has_flag( TFLAG_GOES_UP ) ) {
             tripoint dest( cur.xy(), cur.z + 1 );
             if( vertical_move_destination<TFLAG_GOES_DOWN>( *this, dest ) ) {
-                auto &layer = pf.get_layer( dest.z );
                 pf.add_point( layer.gscore[parent_index] + 2,
                               layer.score[parent_index] + 2 * rl_dist( dest, t ),
                               cur, dest );
@@ -450,7 +553,6 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         }
         if( cur.z < maxz && parent_terrain.has_flag( TFLAG_RAMP ) &&
             valid_move( cur, tripoint( cur.xy(), cur.z + 1 ), false, true ) ) {
-            auto &layer = pf.get_layer( cur.z + 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint above( cur.x + x_offset[it], cur.y + y_offset[it], cur.z + 1 );
                 pf.add_point( layer.gscore[parent_index] + 4,
@@ -467,7 +569,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         for( int fdist = max_length; fdist != 0; fdist-- ) {
             const int cur_index = flat_index( cur.x, cur.y );
             const auto &layer = pf.get_layer( cur.z );
-            const tripoint &par = layer.parent[cur_index];
+            const tripoint par = decode_parent( layer.parent[cur_index], cur );
             if( cur == f ) {
                 break;
             }
@@ -489,3 +591,467 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
     return ret;
 }
+
+void map::build_flow_field( flow_field &field ) const
+{
+    const tripoint &t = field.target;
+    const pathfinding_settings &settings = field.settings;
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( t.z );
+    field.built = true;
+    field.cache_version = pf_cache.version;
+    field.abs_sub = abs_sub;
+    field.distance.assign( MAPSIZE_X * MAPSIZE_Y, flow_field::unreachable );
+    field.next.assign( MAPSIZE_X * MAPSIZE_Y, -1 );
+
+    static thread_local open_list open;
+    static thread_local std::vector<bool> done;
+    open.clear();
+    done.assign( MAPSIZE_X * MAPSIZE_Y, false );
+    // Only starts within max_dist of the target use the field, so it covers that and the
+    // same margin route adds around its search area, not the whole map.
+    const int pad = 16;
+    const int radius = std::max( settings.max_dist, 0 ) + pad;
+    const int min_x = std::max( t.x - radius, 0 );
+    const int min_y = std::max( t.y - radius, 0 );
+    const int max_x = std::min( t.x + radius, SEEX * my_MAPSIZE - 1 );
+    const int max_y = std::min( t.y + radius, SEEY * my_MAPSIZE - 1 );
+
+    field.distance[flat_index( t.x, t.y )] = 0;
+    open.push( 0, t );
+    while( !open.empty() ) {
+        const tripoint cur = open.pop();
+        const int cur_index = flat_index( cur.x, cur.y );
+        if( done[cur_index] ) {
+            continue;
+        }
+        done[cur_index] = true;
+        const int cur_distance = field.distance[cur_index];
+        const pf_special cur_special = pf_cache.special[cur.x][cur.y];
+
+        // The search runs backwards: find the points that step onto cur.
+        for( size_t i = 0; i < eight_horizontal_neighbors.size(); i++ ) {
+            const tripoint from = cur - eight_horizontal_neighbors[i];
+            if( from.x < min_x || from.x > max_x || from.y < min_y || from.y > max_y ) {
+                continue;
+            }
+            const int index = flat_index( from.x, from.y );
+            if( done[index] ) {
+                continue;
+            }
+            const pathfinding_step step = route_step( from, cur, cur_special, settings );
+            if( step.closed ) {
+                // Can't be entered from anywhere, and ledges would need the level below.
+                break;
+            }
+            if( !step.passable ) {
+                continue;
+            }
+            // Same diagonal penalty as in route
+            const int diagonal = from.x != cur.x && from.y != cur.y ? 1 : 0;
+            const int distance = cur_distance + step.cost + diagonal;
+            if( distance > settings.max_length || distance >= field.distance[index] ) {
+                continue;
+            }
+            field.distance[index] = distance;
+            field.next[index] = static_cast<int8_t>( i );
+            open.push( distance, from );
+        }
+    }
+}
+
+std::vector<tripoint> map::route_shared( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings ) const
+{
+    if( f == t || f.z != t.z || !inbounds( f ) || !inbounds( t ) ) {
+        return route( f, t, settings );
+    }
+    if( rl_dist( f, t ) > settings.max_dist ) {
+        // Same as route, only straight lines beyond max_dist
+        return route( f, t, settings );
+    }
+
+    if( flow_fields_turn != calendar::turn ) {
+        flow_fields.clear();
+        flow_fields_turn = calendar::turn;
+    }
+    auto iter = std::find_if( flow_fields.begin(), flow_fields.end(),
+    [&]( const std::unique_ptr<flow_field> &field ) {
+        return field->target == t && field->settings == settings;
+    } );
+    if( iter == flow_fields.end() ) {
+        flow_fields.push_back( std::make_unique<flow_field>() );
+        iter = std::prev( flow_fields.end() );
+        ( *iter )->target = t;
+        ( *iter )->settings = settings;
+    }
+    flow_field &field = **iter;
+    // Searches are cheaper than filling the field for small groups. In route_performance_in_a_crowd
+    // (-O2) a field of max_dist 50 took 620 us, a single route 45 us, and the field was
+    // ahead from about 15 routes on.
+    if( ++field.requests < 16 ) {
+        return route( f, t, settings );
+    }
+
+    if( !field.built || field.cache_version != get_pathfinding_cache_ref( t.z ).version ||
+        field.abs_sub != abs_sub ) {
+        build_flow_field( field );
+    }
+    if( field.distance[flat_index( f.x, f.y )] == flow_field::unreachable ) {
+        // The target may still be reachable via other z-levels.
+        return route( f, t, settings );
+    }
+
+    std::vector<tripoint> ret;
+    tripoint cur = f;
+    while( cur != t ) {
+        const int8_t next = field.next[flat_index( cur.x, cur.y )];
+        if( next < 0 || ret.size() > static_cast<size_t>( settings.max_length ) ) {
+            debugmsg( "Broken flow field from %d:%d:%d to %d:%d:%d", f.x, f.y, f.z, t.x, t.y, t.z );
+            return route( f, t, settings );
+        }
+        cur += eight_horizontal_neighbors[next];
+        ret.push_back( cur );
+    }
+    return ret;
+}
+
+// Whether the portal graph considers a tile walkable. Closed doors are, whether they can be
+// opened depends on the settings, which are only checked when refining the route.
+static bool portal_walkable( const map &m, const pathfinding_cache &pf_cache, const tripoint &p )
+{
+    const pf_special special = pf_cache.special[p.x][p.y];
+    if( !( special & PF_WALL ) || ( special & PF_CLIMBABLE ) ) {
+        return true;
+    }
+    return m.ter( p ).obj().open || m.furn( p ).obj().open;
+}
+
+static int portal_step_cost( const pathfinding_cache &pf_cache, const tripoint &from,
+                             const tripoint &to )
+{
+    const pf_special special = pf_cache.special[to.x][to.y];
+    return 2 + ( from.x != to.x && from.y != to.y ? 1 : 0 ) + ( special & PF_SLOW ? 2 : 0 ) +
+           ( special & PF_WALL ? 4 : 0 );
+}
+
+// Costs of the cheapest paths from `from` to each of `targets` that stay inside the submap of
+// `from`. Unreachable targets are left out.
+static std::vector<portal_edge> paths_inside_submap( const map &m, const pathfinding_cache &pf_cache,
+        const tripoint &from, const std::vector<tripoint> &targets )
+{
+    const point sm_min( from.x / SEEX * SEEX, from.y / SEEY * SEEY );
+    const auto local_index = [&sm_min]( const tripoint & p ) {
+        return ( p.x - sm_min.x ) * SEEY + ( p.y - sm_min.y );
+    };
+    std::array<int, SEEX * SEEY> distance;
+    distance.fill( INT_MAX );
+    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
+    open;
+    distance[local_index( from )] = 0;
+    open.emplace( 0, from );
+    while( !open.empty() ) {
+        const std::pair<int, tripoint> cur = open.top();
+        open.pop();
+        if( cur.first > distance[local_index( cur.second )] ) {
+            continue;
+        }
+        for( const tripoint &offset : eight_horizontal_neighbors ) {
+            const tripoint p = cur.second + offset;
+            if( p.x < sm_min.x || p.x >= sm_min.x + SEEX || p.y < sm_min.y || p.y >= sm_min.y + SEEY ||
+                !portal_walkable( m, pf_cache, p ) ) {
+                continue;
+            }
+            const int dist = cur.first + portal_step_cost( pf_cache, cur.second, p );
+            if( dist < distance[local_index( p )] ) {
+                distance[local_index( p )] = dist;
+                open.emplace( dist, p );
+            }
+        }
+    }
+
+    std::vector<portal_edge> ret;
+    for( const tripoint &p : targets ) {
+        if( p != from && p.z == from.z && distance[local_index( p )] != INT_MAX ) {
+            ret.push_back( portal_edge{ p, distance[local_index( p )] } );
+        }
+    }
+    return ret;
+}
+
+const pathfinding_cache &map::get_portals( const int zlev ) const
+{
+    pathfinding_cache &cache = get_pathfinding_cache( zlev );
+    // Brings the flags up to date
+    get_pathfinding_cache_ref( zlev );
+    if( cache.portals_abs_sub != abs_sub ) {
+        cache.portals_abs_sub = abs_sub;
+        cache.portals_dirty_submaps.set();
+    }
+    if( cache.portals_dirty_submaps.none() ) {
+        return cache;
+    }
+
+    // The nodes on the borders of a changed submap belong to its neighbours as well, so their
+    // nodes and the edges between them are rebuilt too.
+    std::bitset<MAPSIZE *MAPSIZE> rebuild;
+    const auto sm_index = []( const int smx, const int smy ) {
+        return static_cast<size_t>( smx + smy * MAPSIZE );
+    };
+    for( int smx = 0; smx < my_MAPSIZE; smx++ ) {
+        for( int smy = 0; smy < my_MAPSIZE; smy++ ) {
+            if( !cache.portals_dirty_submaps[sm_index( smx, smy )] ) {
+                continue;
+            }
+            rebuild.set( sm_index( smx, smy ) );
+            for( const point &offset : four_adjacent_offsets ) {
+                const point sm( smx + offset.x, smy + offset.y );
+                if( sm.x >= 0 && sm.x < my_MAPSIZE && sm.y >= 0 && sm.y < my_MAPSIZE ) {
+                    rebuild.set( sm_index( sm.x, sm.y ) );
+                }
+            }
+        }
+    }
+    cache.portals_dirty_submaps.reset();
+
+    if( cache.submap_portals.size() != static_cast<size_t>( my_MAPSIZE * my_MAPSIZE ) ) {
+        cache.submap_portals.assign( my_MAPSIZE * my_MAPSIZE, std::vector<tripoint>() );
+    }
+    for( int smx = 0; smx < my_MAPSIZE; smx++ ) {
+        for( int smy = 0; smy < my_MAPSIZE; smy++ ) {
+            if( !rebuild[sm_index( smx, smy )] ) {
+                continue;
+            }
+            std::vector<tripoint> &nodes = cache.submap_portals[smx * my_MAPSIZE + smy];
+            for( const tripoint &node : nodes ) {
+                cache.portals.erase( node );
+            }
+            nodes.clear();
+        }
+    }
+
+    const auto add_node = [&cache, this]( const tripoint & p ) {
+        if( cache.portals.emplace( p, std::vector<portal_edge>() ).second ) {
+            cache.submap_portals[p.x / SEEX * my_MAPSIZE + p.y / SEEY].push_back( p );
+        }
+    };
+    // Runs of tiles along the border between the submap containing `start` and the one
+    // in direction `step` from it, `along` is the direction of the border.
+    // Nodes and edges are only added on the sides that are rebuilt, those of the other side
+    // are still there.
+    const auto add_border = [&]( const tripoint & start, const tripoint & along, const tripoint & step,
+    const bool near_side, const bool far_side ) {
+        int run_start = -1;
+        for( int i = 0; i <= SEEX; i++ ) {
+            const tripoint p = start + along * i;
+            const bool open = i < SEEX && portal_walkable( *this, cache, p ) &&
+                              portal_walkable( *this, cache, p + step );
+            if( open && run_start < 0 ) {
+                run_start = i;
+            } else if( !open && run_start >= 0 ) {
+                const tripoint middle = start + along * ( ( run_start + i - 1 ) / 2 );
+                const int cost = portal_step_cost( cache, middle, middle + step );
+                if( near_side ) {
+                    add_node( middle );
+                    cache.portals[middle].push_back( portal_edge{ middle + step, cost } );
+                }
+                if( far_side ) {
+                    add_node( middle + step );
+                    cache.portals[middle + step].push_back( portal_edge{ middle, cost } );
+                }
+                run_start = -1;
+            }
+        }
+    };
+    for( int smx = 0; smx < my_MAPSIZE; smx++ ) {
+        for( int smy = 0; smy < my_MAPSIZE; smy++ ) {
+            const bool here = rebuild[sm_index( smx, smy )];
+            if( smx + 1 < my_MAPSIZE && ( here || rebuild[sm_index( smx + 1, smy )] ) ) {
+                add_border( tripoint( smx * SEEX + SEEX - 1, smy * SEEY, zlev ), tripoint_south,
+                            tripoint_east, here, rebuild[sm_index( smx + 1, smy )] );
+            }
+            if( smy + 1 < my_MAPSIZE && ( here || rebuild[sm_index( smx, smy + 1 )] ) ) {
+                add_border( tripoint( smx * SEEX, smy * SEEY + SEEY - 1, zlev ), tripoint_east,
+                            tripoint_south, here, rebuild[sm_index( smx, smy + 1 )] );
+            }
+        }
+    }
+
+    // Stairs lead to the matching stairs of the same overmap tile, see map::route.
+    if( has_zlevels() ) {
+        for( int smx = 0; smx < my_MAPSIZE; smx++ ) {
+            for( int smy = 0; smy < my_MAPSIZE; smy++ ) {
+                if( !rebuild[sm_index( smx, smy )] ) {
+                    continue;
+                }
+                for( int x = smx * SEEX; x < smx * SEEX + SEEX; x++ ) {
+                    for( int y = smy * SEEY; y < smy * SEEY + SEEY; y++ ) {
+                        if( !( cache.special[x][y] & PF_UPDOWN ) ) {
+                            continue;
+                        }
+                        const tripoint p( x, y, zlev );
+                        tripoint dest = p;
+                        if( has_flag( TFLAG_GOES_DOWN, p ) && inbounds_z( zlev - 1 ) ) {
+                            dest.z--;
+                            if( !vertical_move_destination<TFLAG_GOES_UP>( *this, dest ) ) {
+                                continue;
+                            }
+                        } else if( has_flag( TFLAG_GOES_UP, p ) && inbounds_z( zlev + 1 ) ) {
+                            dest.z++;
+                            if( !vertical_move_destination<TFLAG_GOES_DOWN>( *this, dest ) ) {
+                                continue;
+                            }
+                        } else {
+                            continue;
+                        }
+                        add_node( p );
+                        // Only one way, the other level adds the way back.
+                        cache.portals[p].push_back( portal_edge{ dest, 2 } );
+                    }
+                }
+            }
+        }
+    }
+
+    for( int smx = 0; smx < my_MAPSIZE; smx++ ) {
+        for( int smy = 0; smy < my_MAPSIZE; smy++ ) {
+            if( !rebuild[sm_index( smx, smy )] ) {
+                continue;
+            }
+            const std::vector<tripoint> &nodes = cache.submap_portals[smx * my_MAPSIZE + smy];
+            for( const tripoint &node : nodes ) {
+                std::vector<portal_edge> &edges = cache.portals[node];
+                for( const portal_edge &edge : paths_inside_submap( *this, cache, node, nodes ) ) {
+                    edges.push_back( edge );
+                }
+            }
+        }
+    }
+    return cache;
+}
+
+std::vector<tripoint> map::route_hierarchical( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings, const std::set<tripoint> &pre_closed ) const
+{
+    if( f == t || !inbounds( f ) || !inbounds( t ) ||
+        ( f.z == t.z && ms_to_sm_copy( f ) == ms_to_sm_copy( t ) ) ||
+        ( f.z == t.z && rl_dist( f, t ) <= SEEX ) ) {
+        // Short enough for a plain search
+        return route( f, t, settings, pre_closed );
+    }
+
+    // Same shortcuts as in map::route: a simple straight line on flat ground...
+    if( f.z == t.z ) {
+        const auto line_path = line_to( f, t );
+        const auto &pf_cache = get_pathfinding_cache_ref( f.z );
+        if( std::all_of( line_path.begin(), line_path.end(), [&pf_cache]( const tripoint & p ) {
+        return !( pf_cache.special[p.x][p.y] & non_normal );
+        } ) ) {
+            const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
+
+            if( is_disjoint( sorted_line, pre_closed ) ) {
+                return line_path;
+            }
+        }
+    }
+
+    // ...and nothing else if the target is too far away
+    if( rl_dist( f, t ) > settings.max_dist ) {
+        return std::vector<tripoint>();
+    }
+
+    // Links from the start into the portal graph and from the graph to the target.
+    const pathfinding_cache &start_level = get_portals( f.z );
+    const std::vector<tripoint> &start_nodes =
+        start_level.submap_portals[f.x / SEEX * my_MAPSIZE + f.y / SEEY];
+    const std::vector<portal_edge> start_edges = paths_inside_submap( *this, start_level, f,
+            start_nodes );
+    const pathfinding_cache &target_level = get_portals( t.z );
+    std::unordered_map<tripoint, int> target_edges;
+    for( const portal_edge &edge : paths_inside_submap( *this, target_level, t,
+            target_level.submap_portals[t.x / SEEX * my_MAPSIZE + t.y / SEEY] ) ) {
+        target_edges[edge.to] = edge.cost;
+    }
+
+    // A* over the portal graph
+    std::unordered_map<tripoint, int> gscore;
+    std::unordered_map<tripoint, tripoint> parent;
+    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
+    open;
+    const auto add_node = [&]( const tripoint & from, const tripoint & to, const int cost ) {
+        if( cost > settings.max_length ) {
+            // The whole route is held to the limit, like in map::route, not each refined leg
+            return;
+        }
+        const auto iter = gscore.find( to );
+        if( iter != gscore.end() && iter->second <= cost ) {
+            return;
+        }
+        gscore[to] = cost;
+        parent[to] = from;
+        open.emplace( cost + 2 * rl_dist( to, t ), to );
+    };
+    for( const portal_edge &edge : start_edges ) {
+        add_node( f, edge.to, edge.cost );
+    }
+    bool found = false;
+    while( !open.empty() ) {
+        const std::pair<int, tripoint> top = open.top();
+        open.pop();
+        const tripoint &cur = top.second;
+        if( cur == t ) {
+            found = true;
+            break;
+        }
+        const int cur_score = gscore[cur];
+        if( top.first != cur_score + 2 * rl_dist( cur, t ) ) {
+            // Found a cheaper way to this node since this entry was added
+            continue;
+        }
+        const auto target_edge = target_edges.find( cur );
+        if( target_edge != target_edges.end() ) {
+            add_node( cur, t, cur_score + target_edge->second );
+        }
+        if( !inbounds_z( cur.z ) ) {
+            continue;
+        }
+        const pathfinding_cache &level = get_portals( cur.z );
+        const auto edges = level.portals.find( cur );
+        if( edges == level.portals.end() ) {
+            continue;
+        }
+        for( const portal_edge &edge : edges->second ) {
+            if( edge.to.z != cur.z && !settings.allow_climb_stairs ) {
+                continue;
+            }
+            add_node( cur, edge.to, cur_score + edge.cost );
+        }
+    }
+    if( !found ) {
+        return route( f, t, settings, pre_closed );
+    }
+
+    std::vector<tripoint> waypoints;
+    for( tripoint cur = t; cur != f; cur = parent[cur] ) {
+        waypoints.push_back( cur );
+    }
+    std::reverse( waypoints.begin(), waypoints.end() );
+
+    // Refine the corridor, each leg is a short search inside one or two submaps.
+    std::vector<tripoint> ret;
+    tripoint cur = f;
+    for( const tripoint &next : waypoints ) {
+        if( next.z != cur.z ) {
+            // Stairs, the route jumps to the destination just like map::route does.
+            ret.push_back( next );
+        } else {
+            const std::vector<tripoint> leg = route( cur, next, settings, pre_closed );
+            if( leg.empty() ) {
+                // The graph ignores the settings, the creature might not be able to go there.
+                return route( f, t, settings, pre_closed );
+            }
+            ret.insert( ret.end(), leg.begin(), leg.end() );
+        }
+        cur = next;
+    }
+    return ret;
+}
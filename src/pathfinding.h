@@ -2,7 +2,14 @@
 #ifndef PATHFINDING_H
 #define PATHFINDING_H
 
+#include <bitset>
+#include <climits>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 #include "game_constants.h"
+#include "point.h"
 
 enum pf_special : char {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
@@ -37,13 +44,37 @@ inline pf_special &operator &= ( pf_special &lhs, pf_special rhs )
     return lhs;
 }
 
+// Connection in the portal graph of pathfinding_cache
+struct portal_edge {
+    tripoint to;
+    int cost;
+};
+
 struct pathfinding_cache {
     pathfinding_cache();
     ~pathfinding_cache();
 
     bool dirty;
+    // Incremented every time the cache is rebuilt
+    unsigned int version;
 
     pf_special special[MAPSIZE_X][MAPSIZE_Y];
+
+    /**
+     * Abstract graph of the z-level for long routes, see map::route_hierarchical.
+     * Each run of walkable tiles along a submap border is a portal, with a node on both
+     * sides of the border. Stairs are nodes too, linked to their destination on the other
+     * z-level. Nodes of the same submap are linked if a path inside the submap connects them.
+     * Built on demand from the flags above.
+     */
+    std::unordered_map<tripoint, std::vector<portal_edge>> portals;
+    // Nodes of each submap, indexed by submap x * map size + submap y
+    std::vector<std::vector<tripoint>> submap_portals;
+    // Submaps whose nodes and edges have to be rebuilt, indexed like the dirty submaps
+    // of the level cache
+    std::bitset<MAPSIZE *MAPSIZE> portals_dirty_submaps;
+    // The map position the portals were built for
+    tripoint portals_abs_sub;
 };
 
 struct pathfinding_settings {
@@ -66,6 +97,49 @@ struct pathfinding_settings {
     pathfinding_settings( int bs, int md, int ml, int cc, bool aod, bool at, bool acs, bool art )
         : bash_strength( bs ), max_dist( md ), max_length( ml ), climb_cost( cc ),
           allow_open_doors( aod ), avoid_traps( at ), allow_climb_stairs( acs ), avoid_rough_terrain( art ) {}
+
+    bool operator==( const pathfinding_settings &rhs ) const {
+        return bash_strength == rhs.bash_strength && max_dist == rhs.max_dist &&
+               max_length == rhs.max_length && climb_cost == rhs.climb_cost &&
+               allow_open_doors == rhs.allow_open_doors && avoid_traps == rhs.avoid_traps &&
+               allow_climb_stairs == rhs.allow_climb_stairs &&
+               avoid_rough_terrain == rhs.avoid_rough_terrain;
+    }
+};
+
+// Result of map::route_step
+struct pathfinding_step {
+    // Cost of entering the tile, only valid if it is passable
+    int cost = 0;
+    bool passable = true;
+    // The tile can't be entered from any side, implies not passable
+    bool closed = false;
+    // The tile is a ledge to drop down from (only checked when avoiding traps), implies closed
+    bool ledge = false;
+};
+
+/**
+ * Distances to a single target from every point of its z-level, built by one search
+ * starting at the target. Creatures converging on the same target share it instead of
+ * each searching on their own, see @ref map::route_shared.
+ */
+struct flow_field {
+    static constexpr int unreachable = INT_MAX;
+
+    tripoint target;
+    pathfinding_settings settings;
+    // Number of routes to the target requested during the current turn
+    int requests = 0;
+
+    // Whether the arrays below are filled
+    bool built = false;
+    // The pathfinding cache version and map position the field was built for
+    unsigned int cache_version = 0;
+    tripoint abs_sub;
+    // Cost of the cheapest path from each point to the target, indexed like the A* layers
+    std::vector<int> distance;
+    // Index of the next step towards the target in eight_horizontal_neighbors
+    std::vector<int8_t> next;
 };
 
 #endif
@@ -1243,6 +1243,12 @@ class player : public Character
          * complete the first step (total / 20 + total % 20 charges)
          */
         bool can_start_craft( const recipe *rec, int batch_size = 1 );
+        /**
+         * Same as can_start_craft with a batch size of 1 for each of the recipes, but checks
+         * tools and qualities shared by the recipes only once. The results are kept until the
+         * crafting inventory is formed anew.
+         */
+        std::vector<bool> can_start_crafts( const std::vector<const recipe *> &recipes );
         bool making_would_work( const recipe_id &id_to_make, int batch_size );
 
         /**
@@ -1298,6 +1304,8 @@ class player : public Character
 
         // yet more crafting.cpp
         // includes nearby items
+        // Formed anew at most once per turn, position and radius; requirement checks use the
+        // type and quality indices of the result (see inventory::get_quality_index).
         const inventory &crafting_inventory( const tripoint &src_pos = tripoint_zero,
                                              int radius = PICKUP_RANGE );
         void invalidate_crafting_inventory();
@@ -1596,6 +1604,9 @@ class player : public Character
         int cached_moves;
         time_point cached_time;
         tripoint cached_position;
+        int cached_radius = 0;
+        /** Results of can_start_crafts for @ref cached_crafting_inventory. */
+        std::unordered_map<const recipe *, bool> cached_start_craft;
 
     private:
 
@@ -577,7 +577,8 @@ std::vector<std::string> requirement_data::get_folded_tools_list( int width, nc_
 }
 
 bool requirement_data::can_make_with_inventory( const inventory &crafting_inv,
-        const std::function<bool( const item & )> &filter, int batch ) const
+        const std::function<bool( const item & )> &filter, int batch,
+        requirement_check_cache *cache ) const
 {
     if( g->u.has_trait( trait_DEBUG_HS ) ) {
         return true;
@@ -585,10 +586,10 @@ bool requirement_data::can_make_with_inventory( const inventory &crafting_inv,
 
     bool retval = true;
     // All functions must be called to update the available settings in the components.
-    if( !has_comps( crafting_inv, qualities, return_true<item> ) ) {
+    if( !has_comps( crafting_inv, qualities, return_true<item>, 1, cache ) ) {
         retval = false;
     }
-    if( !has_comps( crafting_inv, tools, return_true<item>, batch ) ) {
+    if( !has_comps( crafting_inv, tools, return_true<item>, batch, cache ) ) {
         retval = false;
     }
     if( !has_comps( crafting_inv, components, filter, batch ) ) {
@@ -600,11 +601,57 @@ bool requirement_data::can_make_with_inventory( const inventory &crafting_inv,
     return retval;
 }
 
+// Components are never cached, see requirement_check_cache.
+static bool has_requirement( const item_comp &comp, const inventory &crafting_inv,
+                             const std::function<bool( const item & )> &filter, int batch,
+                             const std::function<void( int )> &visitor, requirement_check_cache * )
+{
+    return comp.has( crafting_inv, filter, batch, visitor );
+}
+
+static bool has_requirement( const quality_requirement &qual, const inventory &crafting_inv,
+                             const std::function<bool( const item & )> &filter, int batch,
+                             const std::function<void( int )> &visitor, requirement_check_cache *cache )
+{
+    if( cache == nullptr ) {
+        return qual.has( crafting_inv, filter, batch, visitor );
+    }
+    const auto key = std::make_tuple( qual.type, qual.level, qual.count );
+    auto iter = cache->qualities.find( key );
+    if( iter == cache->qualities.end() ) {
+        iter = cache->qualities.emplace( key, qual.has( crafting_inv, filter, batch, visitor ) ).first;
+    }
+    return iter->second;
+}
+
+static bool has_requirement( const tool_comp &tool, const inventory &crafting_inv,
+                             const std::function<bool( const item & )> &filter, int batch,
+                             const std::function<void( int )> &visitor, requirement_check_cache *cache )
+{
+    if( cache == nullptr ) {
+        return tool.has( crafting_inv, filter, batch, visitor );
+    }
+    const auto key = std::make_tuple( tool.type, tool.count, batch );
+    auto iter = cache->tools.find( key );
+    if( iter == cache->tools.end() ) {
+        requirement_check_cache::tool_result result;
+        result.found = tool.has( crafting_inv, filter, batch, [&result]( int charges ) {
+            result.ups_charges = std::min( result.ups_charges, charges );
+        } );
+        iter = cache->tools.emplace( key, result ).first;
+    }
+    // Only the least charges matter to the caller.
+    if( iter->second.ups_charges != std::numeric_limits<int>::max() ) {
+        visitor( iter->second.ups_charges );
+    }
+    return iter->second.found;
+}
+
 template<typename T>
 bool requirement_data::has_comps( const inventory &crafting_inv,
                                   const std::vector< std::vector<T> > &vec,
                                   const std::function<bool( const item & )> &filter,
-                                  int batch )
+                                  int batch, requirement_check_cache *cache )
 {
     bool retval = true;
     int total_UPS_charges_used = 0;
@@ -612,9 +659,9 @@ bool requirement_data::has_comps( const inventory &crafting_inv,
         bool has_tool_in_set = false;
         int UPS_charges_used = std::numeric_limits<int>::max();
         for( const auto &tool : set_of_tools ) {
-            if( tool.has( crafting_inv, filter, batch, [ &UPS_charges_used ]( int charges ) {
+            if( has_requirement( tool, crafting_inv, filter, batch, [ &UPS_charges_used ]( int charges ) {
             UPS_charges_used = std::min( UPS_charges_used, charges );
-            } ) ) {
+            }, cache ) ) {
                 tool.available = a_true;
             } else {
                 tool.available = a_false;
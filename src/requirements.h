@@ -3,8 +3,10 @@
 #define REQUIREMENTS_H
 
 #include <functional>
+#include <limits>
 #include <list>
 #include <map>
+#include <tuple>
 #include <vector>
 #include <string>
 #include <utility>
@@ -126,6 +128,24 @@ struct quality_requirement {
     }
 };
 
+/**
+ * Results of the tool and quality checks done by @ref requirement_data::can_make_with_inventory,
+ * so that checking many requirements against the same inventory does every distinct check
+ * only once. Components aren't kept, their checks depend on the filter of the recipe.
+ * Only valid as long as the inventory doesn't change.
+ */
+struct requirement_check_cache {
+    struct tool_result {
+        bool found = false;
+        /** The least UPS charges reported by the check, if it reported any. */
+        int ups_charges = std::numeric_limits<int>::max();
+    };
+    /** Keyed by type, level and count. */
+    std::map<std::tuple<quality_id, int, int>, bool> qualities;
+    /** Keyed by type, count and batch size. */
+    std::map<std::tuple<itype_id, int, int>, tool_result> tools;
+};
+
 /**
  * The *_vector members represent list of alternatives requirements:
  * alter_tool_comp_vector = { * { { a, b }, { c, d } }
@@ -263,9 +283,11 @@ struct requirement_data {
          * Returns true if the requirements are fufilled by the filtered inventory
          * @param filter should be recipe::get_component_filter() if used with a recipe
          * or is_crafting_component otherwise.
+         * @param cache if given, tool and quality checks are looked up in and added to it.
          */
         bool can_make_with_inventory( const inventory &crafting_inv,
-                                      const std::function<bool( const item & )> &filter, int batch = 1 ) const;
+                                      const std::function<bool( const item & )> &filter, int batch = 1,
+                                      requirement_check_cache *cache = nullptr ) const;
 
         /** @param filter see @ref can_make_with_inventory */
         std::vector<std::string> get_folded_components_list( int width, nc_color col,
@@ -316,7 +338,8 @@ struct requirement_data {
                                                const std::vector< std::vector<T> > &objs );
         template<typename T>
         static bool has_comps( const inventory &crafting_inv, const std::vector< std::vector<T> > &vec,
-                               const std::function<bool( const item & )> &filter, int batch = 1 );
+                               const std::function<bool( const item & )> &filter, int batch = 1,
+                               requirement_check_cache *cache = nullptr );
 
         template<typename T>
         std::vector<std::string> get_folded_list( int width, const inventory &crafting_inv,
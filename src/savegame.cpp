@@ -933,6 +933,7 @@ void overmap::unserialize( std::istream &fin )
                 jsin.end_array();
             }
             jsin.end_array();
+            ter_locations.clear();
             convert_terrain( needs_conversion );
         } else if( name == "region_id" ) {
             std::string new_region_id;
@@ -1707,8 +1708,7 @@ void faction_manager::deserialize( JsonIn &jsin )
 
 void Creature_tracker::deserialize( JsonIn &jsin )
 {
-    monsters_list.clear();
-    monsters_by_location.clear();
+    clear();
     jsin.start_array();
     while( !jsin.end_array() ) {
         // @todo would be nice if monster had a constructor using JsonIn or similar, so this could be one statement.
@@ -3055,47 +3055,124 @@ void player_morale::load( JsonObject &jsin )
     jsin.read( "morale", points );
 }
 
-void map_memory::store( JsonOut &jsout ) const
+template<typename T, size_t N>
+static void write_rle( JsonOut &jsout, const std::array<T, N> &values )
 {
+    // Flat list of value, count pairs. Most chunks are largely uniform (or empty).
     jsout.start_array();
-    jsout.start_array();
-    for( const auto &elem : tile_cache.list() ) {
-        jsout.start_array();
-        jsout.write( elem.first.x );
-        jsout.write( elem.first.y );
-        jsout.write( elem.first.z );
-        jsout.write( elem.second.tile );
-        jsout.write( elem.second.subtile );
-        jsout.write( elem.second.rotation );
-        jsout.end_array();
+    for( size_t i = 0; i < N; ) {
+        size_t count = 1;
+        while( i + count < N && values[i + count] == values[i] ) {
+            count++;
+        }
+        jsout.write( values[i] );
+        jsout.write( count );
+        i += count;
     }
     jsout.end_array();
+}
+
+template<typename T, size_t N>
+static void read_rle( JsonIn &jsin, std::array<T, N> &values )
+{
+    size_t i = 0;
+    jsin.start_array();
+    while( !jsin.end_array() ) {
+        const T value = jsin.get_int();
+        const int count = jsin.get_int();
+        if( count <= 0 || i + count > N ) {
+            jsin.error( "invalid number of values in map memory chunk" );
+        }
+        std::fill_n( values.begin() + i, count, value );
+        i += count;
+    }
+    if( i != N ) {
+        jsin.error( "too few values in map memory chunk" );
+    }
+}
 
+void map_memory::store( JsonOut &jsout ) const
+{
+    jsout.start_object();
+    // Must be the first member, load relies on it to tell this format from the legacy one.
+    jsout.member( "tile_names", tile_names );
+
+    jsout.member( "chunks" );
     jsout.start_array();
-    for( const auto &elem : symbol_cache.list() ) {
+    // Least recently written first, loading restores the order this way.
+    for( const tripoint &chunk_pos : lru ) {
+        const memorized_submap &chunk = chunks.at( chunk_pos );
         jsout.start_array();
-        jsout.write( elem.first.x );
-        jsout.write( elem.first.y );
-        jsout.write( elem.first.z );
-        jsout.write( elem.second );
+        jsout.write( chunk_pos.x );
+        jsout.write( chunk_pos.y );
+        jsout.write( chunk_pos.z );
+        write_rle( jsout, chunk.tiles );
+        write_rle( jsout, chunk.subtiles );
+        write_rle( jsout, chunk.rotations );
+        write_rle( jsout, chunk.symbols );
         jsout.end_array();
     }
     jsout.end_array();
-    jsout.end_array();
+    jsout.end_object();
 }
 
 void map_memory::load( JsonIn &jsin )
 {
-    // Legacy loading of object version.
+    clear();
     if( jsin.test_object() ) {
-        JsonObject jsobj = jsin.get_object();
-        load( jsobj );
+        const int start = jsin.tell();
+        jsin.start_object();
+        if( jsin.get_member_name() != "tile_names" ) {
+            // Legacy loading of object version.
+            jsin.seek( start );
+            JsonObject jsobj = jsin.get_object();
+            load( jsobj );
+            return;
+        }
+        tile_names.clear();
+        tile_ids.clear();
+        jsin.read( tile_names );
+        if( tile_names.empty() || !tile_names.front().empty() ) {
+            jsin.error( "map memory tile names must start with the empty name" );
+        }
+        for( size_t i = 1; i < tile_names.size(); i++ ) {
+            tile_ids.emplace( tile_names[i], static_cast<int>( i ) );
+        }
+        while( !jsin.end_object() ) {
+            const std::string name = jsin.get_member_name();
+            if( name != "chunks" ) {
+                jsin.skip_value();
+                continue;
+            }
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                jsin.start_array();
+                tripoint chunk_pos;
+                chunk_pos.x = jsin.get_int();
+                chunk_pos.y = jsin.get_int();
+                chunk_pos.z = jsin.get_int();
+                memorized_submap &chunk = chunks[chunk_pos];
+                read_rle( jsin, chunk.tiles );
+                read_rle( jsin, chunk.subtiles );
+                read_rle( jsin, chunk.rotations );
+                read_rle( jsin, chunk.symbols );
+                jsin.end_array();
+                chunk.memorized = 0;
+                for( size_t i = 0; i < chunk_size; i++ ) {
+                    if( chunk.tiles[i] < 0 || static_cast<size_t>( chunk.tiles[i] ) >= tile_names.size() ) {
+                        jsin.error( "invalid tile in map memory chunk" );
+                    }
+                    if( chunk.has_memory( i ) ) {
+                        chunk.memorized++;
+                    }
+                }
+                memorized_tiles += chunk.memorized;
+                chunk.lru_position = lru.insert( lru.end(), chunk_pos );
+            }
+        }
     } else {
-        // This file is large enough that it's more than called for to minimize the
-        // amount of data written and read and make it a bit less "friendly",
-        // and use the streaming interface.
+        // Previous format, one entry per location.
         jsin.start_array();
-        tile_cache.clear();
         jsin.start_array();
         while( !jsin.end_array() ) {
             jsin.start_array();
@@ -3110,7 +3187,6 @@ void map_memory::load( JsonIn &jsin )
                            tile, subtile, rotation );
             jsin.end_array();
         }
-        symbol_cache.clear();
         jsin.start_array();
         while( !jsin.end_array() ) {
             jsin.start_array();
@@ -3130,7 +3206,7 @@ void map_memory::load( JsonIn &jsin )
 void map_memory::load( JsonObject &jsin )
 {
     JsonArray map_memory_tiles = jsin.get_array( "map_memory_tiles" );
-    tile_cache.clear();
+    clear();
     while( map_memory_tiles.has_more() ) {
         JsonObject pmap = map_memory_tiles.next_object();
         const tripoint p( pmap.get_int( "x" ), pmap.get_int( "y" ), pmap.get_int( "z" ) );
@@ -3139,7 +3215,6 @@ void map_memory::load( JsonObject &jsin )
     }
 
     JsonArray map_memory_curses = jsin.get_array( "map_memory_curses" );
-    symbol_cache.clear();
     while( map_memory_curses.has_more() ) {
         JsonObject pmap = map_memory_curses.next_object();
         const tripoint p( pmap.get_int( "x" ), pmap.get_int( "y" ), pmap.get_int( "z" ) );
@@ -3563,12 +3638,13 @@ void submap::store( JsonOut &jsout ) const
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
         for( int i = 0; i < SEEX; i++ ) {
-            if( itm[i][j].empty() ) {
+            const cata::colony<item> &items = itm.peek( { i, j } );
+            if( items.empty() ) {
                 continue;
             }
             jsout.write( i );
             jsout.write( j );
-            jsout.write( itm[i][j] );
+            jsout.write( items );
         }
     }
     jsout.end_array();
@@ -3596,11 +3672,12 @@ void submap::store( JsonOut &jsout ) const
     for( int j = 0; j < SEEY; j++ ) {
         for( int i = 0; i < SEEX; i++ ) {
             // Save fields
-            if( fld[i][j].field_count() > 0 ) {
+            const field &fields = fld.peek( { i, j } );
+            if( fields.field_count() > 0 ) {
                 jsout.write( i );
                 jsout.write( j );
                 jsout.start_array();
-                for( auto &elem : fld[i][j] ) {
+                for( auto &elem : fields ) {
                     const field_entry &cur = elem.second;
                     jsout.write( cur.get_field_type().id() );
                     jsout.write( cur.get_field_intensity() );
@@ -3707,13 +3784,13 @@ void submap::load( JsonIn &jsin, const std::string &member_name, bool rubpow_upd
                     if( tid == "t_rubble" ) {
                         ter[i][j] = ter_id( "t_dirt" );
                         frn[i][j] = furn_id( "f_rubble" );
-                        itm[i][j].insert( rock );
-                        itm[i][j].insert( rock );
+                        itm.get( { i, j } ).insert( rock );
+                        itm.get( { i, j } ).insert( rock );
                     } else if( tid == "t_wreckage" ) {
                         ter[i][j] = ter_id( "t_dirt" );
                         frn[i][j] = furn_id( "f_wreckage" );
-                        itm[i][j].insert( chunk );
-                        itm[i][j].insert( chunk );
+                        itm.get( { i, j } ).insert( chunk );
+                        itm.get( { i, j } ).insert( chunk );
                     } else if( tid == "t_ash" ) {
                         ter[i][j] = ter_id( "t_dirt" );
                         frn[i][j] = furn_id( "f_ash" );
@@ -3796,12 +3873,12 @@ void submap::load( JsonIn &jsin, const std::string &member_name, bool rubpow_upd
 
                 tmp.visit_items( [ this, &p ]( item * it ) {
                     for( auto &e : it->magazine_convert() ) {
-                        itm[p.x][p.y].insert( e );
+                        itm.get( p ).insert( e );
                     }
                     return VisitResponse::NEXT;
                 } );
 
-                const cata::colony<item>::iterator it = itm[p.x][p.y].insert( tmp );
+                const cata::colony<item>::iterator it = itm.get( p ).insert( tmp );
                 if( tmp.needs_processing() ) {
                     active_items.add( *it, p );
                 }
@@ -3848,10 +3925,11 @@ void submap::load( JsonIn &jsin, const std::string &member_name, bool rubpow_upd
                 } else {
                     ft = field_types::get_field_type_by_legacy_enum( type_int ).id;
                 }
-                if( fld[i][j].find_field( ft ) == nullptr ) {
+                field &fields = fld.get( { i, j } );
+                if( fields.find_field( ft ) == nullptr ) {
                     field_count++;
                 }
-                fld[i][j].add_field( ft, intensity, time_duration::from_turns( age ) );
+                fields.add_field( ft, intensity, time_duration::from_turns( age ) );
             }
         }
     } else if( member_name == "graffiti" ) {
@@ -142,91 +142,84 @@ void scent_map::update( const tripoint &center, map &m )
         return;
     }
 
-    // note: the next four intermediate matrices need to be at least
-    // [2*SCENT_RADIUS+3][2*SCENT_RADIUS+1] in size to hold enough data
-    // The code I'm modifying used [MAPSIZE_X]. I'm staying with that to avoid new bugs.
-
-    // These two matrices are transposed so that x addresses are contiguous in memory
-    scent_array<int> sum_3_scent_y;
-    scent_array<int> squares_used_y;
-
-    // these are for caching flag lookups
-    scent_array<bool> blocks_scent; // currently only TFLAG_WALL blocks scent
-    scent_array<bool> reduces_scent;
-
     // for loop constants
     const int scentmap_minx = center.x - SCENT_RADIUS;
     const int scentmap_maxx = center.x + SCENT_RADIUS;
     const int scentmap_miny = center.y - SCENT_RADIUS;
     const int scentmap_maxy = center.y + SCENT_RADIUS;
 
-    // decrease this to reduce gas spread. Keep it under 125 for
-    // stability. This is essentially a decimal number * 1000.
-    const int diffusivity = 100;
+    // these are for caching flag lookups
+    scent_array<bool> blocks_scent; // currently only TFLAG_WALL blocks scent
+    scent_array<bool> reduces_scent;
 
     // The new scent flag searching function. Should be wayyy faster than the old one.
     m.scent_blockers( blocks_scent, reduces_scent, point( scentmap_minx - 1, scentmap_miny - 1 ),
                       point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
-    // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
-    // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
-    // is a net performance improvement over the old code. Could probably still be better.
-    // note: this method needs an array that is one square larger on each side in the x direction
-    // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
-    // MAPSIZE_X, but if that changes, this may need tweaking.
+
+    // Turn the flags into weights once, so the diffusion itself doesn't need to branch on them
+    scent_array<int> weights;
     for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+        for( int y = scentmap_miny - 1; y <= scentmap_maxy + 1; ++y ) {
+            // only 20% of scent can diffuse on REDUCE_SCENT squares
+            weights[x][y] = blocks_scent[x][y] ? 0 : reduces_scent[x][y] ? 2 : 10;
+        }
+    }
+
+    diffuse( grscent, weights, point( scentmap_minx, scentmap_miny ),
+             point( scentmap_maxx, scentmap_maxy ) );
+}
+
+void scent_map::diffuse( scent_array<int> &scents, const scent_array<int> &weights,
+                         const point &min, const point &max )
+{
+    // decrease this to reduce gas spread. Keep it under 125 for
+    // stability. This is essentially a decimal number * 1000.
+    constexpr int diffusivity = 100;
+
+    // Both intermediate matrices are laid out like the scent map, so every inner loop below
+    // walks contiguous memory without branches and can be vectorized by the compiler.
+    scent_array<int> sum_3_scent_y;
+    scent_array<int> squares_used_y;
+
+    // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
+    // times.
+    // note: this needs the squares one step outside of the final scent matrix in the x direction.
+    for( int x = min.x - 1; x <= max.x + 1; ++x ) {
+        const auto &weight = weights[x];
+        const auto &scent = scents[x];
+        auto &sum_3_scent = sum_3_scent_y[x];
+        auto &squares_used = squares_used_y[x];
+        for( int y = min.y; y <= max.y; ++y ) {
             // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = y - 1; i <= y + 1; ++i ) {
-                if( !blocks_scent[x][i] ) {
-                    if( reduces_scent[x][i] ) {
-                        // only 20% of scent can diffuse on REDUCE_SCENT squares
-                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
-                        squares_used_y[y][x] += 2;
-                    } else {
-                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
-                        squares_used_y[y][x] += 10;
-                    }
-                }
-            }
+            sum_3_scent[y] = weight[y - 1] * scent[y - 1] + weight[y] * scent[y] +
+                             weight[y + 1] * scent[y + 1];
+            squares_used[y] = weight[y - 1] + weight[y] + weight[y + 1];
         }
     }
 
     // Rest of the scent map
-    for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            auto &scent_here = grscent[x][y];
-            if( !blocks_scent[x][y] ) {
-                // to how many neighboring squares do we diffuse out? (include our own square
-                // since we also include our own square when diffusing in)
-                const int squares_used = squares_used_y[y][x - 1]
-                                         + squares_used_y[y][x]
-                                         + squares_used_y[y][x + 1];
-
-                int this_diffusivity;
-                if( !reduces_scent[x][y] ) {
-                    this_diffusivity = diffusivity;
-                } else {
-                    this_diffusivity = diffusivity / 5; //less air movement for REDUCE_SCENT square
-                }
-                // take the old scent and subtract what diffuses out
-                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
-                // neighboring walls and reduce_scent squares absorb some scent
-                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
-                // we've already summed neighboring scent values in the y direction in the previous
-                // loop. Now we do it for the x direction, multiply by diffusion, and this is what
-                // diffuses into our current square.
-                scent_here =
-                    ( temp_scent
-                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
-                                             + sum_3_scent_y[y][x]
-                                             + sum_3_scent_y[y][x + 1] )
-                    ) / ( 1000 * 10 );
-            } else {
-                // this cell blocks scent
-                scent_here = 0;
-            }
+    for( int x = min.x; x <= max.x; ++x ) {
+        const auto &weight = weights[x];
+        auto &scent = scents[x];
+        for( int y = min.y; y <= max.y; ++y ) {
+            // to how many neighboring squares do we diffuse out? (include our own square
+            // since we also include our own square when diffusing in)
+            const int squares_used = squares_used_y[x - 1][y] + squares_used_y[x][y] +
+                                     squares_used_y[x + 1][y];
+            // less air movement for REDUCE_SCENT squares, none at all in walls
+            const int this_diffusivity = diffusivity * weight[y] / 10;
+            const int scent_here = scent[y];
+            // take the old scent and subtract what diffuses out
+            int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+            // neighboring walls and reduce_scent squares absorb some scent
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+            // we've already summed neighboring scent values in the y direction in the previous
+            // loop. Now we do it for the x direction, multiply by diffusion, and this is what
+            // diffuses into our current square.
+            const int new_scent = ( temp_scent + this_diffusivity * ( sum_3_scent_y[x - 1][y] +
+                                    sum_3_scent_y[x][y] + sum_3_scent_y[x + 1][y] ) ) / ( 1000 * 10 );
+            // squares that block scent don't hold any
+            scent[y] = weight[y] != 0 ? new_scent : 0;
         }
     }
 }
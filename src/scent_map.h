@@ -23,10 +23,11 @@ class window;
 
 class scent_map
 {
-    protected:
+    public:
         template<typename T>
         using scent_array = std::array<std::array<T, MAPSIZE_Y>, MAPSIZE_X>;
 
+    protected:
         scent_array<int> grscent;
         cata::optional<tripoint> player_last_position;
         time_point player_last_moved = calendar::before_time_starts;
@@ -42,6 +43,14 @@ class scent_map
         void draw( const catacurses::window &win, int div, const tripoint &center ) const;
 
         void update( const tripoint &center, map &m );
+        /**
+         * One step of scent diffusion over the square from @p min to @p max (inclusive).
+         * Squares one step outside of it are read, but not changed.
+         * @param weights How much each square takes part in the diffusion: 0 for squares
+         * that block scent, 2 for squares that reduce it and 10 for all others.
+         */
+        static void diffuse( scent_array<int> &scents, const scent_array<int> &weights,
+                             const point &min, const point &max );
         void reset();
         void decay();
         void shift( int sm_shift_x, int sm_shift_y );
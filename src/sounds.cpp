@@ -12,6 +12,7 @@
 
 #include "avatar.h"
 #include "coordinate_conversions.h"
+#include "creature_tracker.h"
 #include "debug.h"
 #include "effect.h"
 #include "enums.h"
@@ -172,68 +173,45 @@ void sounds::add_footstep( const tripoint &p, int volume, int, monster *,
                                          sound_t::movement, footstep, false, true, "", ""} ) );
 }
 
-template <typename C>
-static void vector_quick_remove( std::vector<C> &source, int index )
-{
-    if( source.size() != 1 ) {
-        // Swap the target and the last element of the vector.
-        // This scrambles the vector, but makes removal O(1).
-        std::iter_swap( source.begin() + index, source.end() - 1 );
-    }
-    source.pop_back();
-}
-
-static std::vector<centroid> cluster_sounds( std::vector<std::pair<tripoint, int>> recent_sounds )
+static const std::vector<centroid> &cluster_sounds(
+    const std::vector<std::pair<tripoint, int>> &recent_sounds )
 {
     // If there are too many monsters and too many noise sources (which can be monsters, go figure),
     // applying sound events to monsters can dominate processing time for the whole game,
     // so we cluster sounds and apply the centroids of the sounds to the monster AI
     // to fight the combinatorial explosion.
-    std::vector<centroid> sound_clusters;
-    const int num_seed_clusters = std::max( std::min( recent_sounds.size(), static_cast<size_t>( 10 ) ),
-                                            static_cast<size_t>( log( recent_sounds.size() ) ) );
-    const size_t stopping_point = recent_sounds.size() - num_seed_clusters;
-    const size_t max_map_distance = rl_dist( point_zero, point( MAPSIZE_X, MAPSIZE_Y ) );
-    // Randomly choose cluster seeds.
-    for( size_t i = recent_sounds.size(); i > stopping_point; i-- ) {
-        size_t index = rng( 0, i - 1 );
-        // The volume and cluster weight are the same for the first element.
-        sound_clusters.push_back(
-            // Assure the compiler that these int->float conversions are safe.
-        {
-            static_cast<float>( recent_sounds[index].first.x ), static_cast<float>( recent_sounds[index].first.y ),
-            static_cast<float>( recent_sounds[index].first.z ),
-            static_cast<float>( recent_sounds[index].second ), static_cast<float>( recent_sounds[index].second )
-        } );
-        vector_quick_remove( recent_sounds, index );
-    }
+    // Sounds are binned by the submap (and z-level) they originate in, each bin becomes one
+    // cluster. Clusters are ordered by the first sound that falls into them, so the result
+    // only depends on the order of the sounds.
+    // Both containers are reused from turn to turn to avoid allocating them anew each time.
+    static std::vector<centroid> sound_clusters;
+    static std::unordered_map<tripoint, size_t> cluster_of_submap;
+    sound_clusters.clear();
+    cluster_of_submap.clear();
     for( const auto &sound_event_pair : recent_sounds ) {
-        auto found_centroid = sound_clusters.begin();
-        float dist_factor = max_map_distance;
-        const auto cluster_end = sound_clusters.end();
-        for( auto centroid_iter = sound_clusters.begin(); centroid_iter != cluster_end;
-             ++centroid_iter ) {
-            // Scale the distance between the two by the max possible distance.
-            tripoint centroid_pos { static_cast<int>( centroid_iter->x ), static_cast<int>( centroid_iter->y ), static_cast<int>( centroid_iter->z ) };
-            const int dist = rl_dist( sound_event_pair.first, centroid_pos );
-            if( dist * dist < dist_factor ) {
-                found_centroid = centroid_iter;
-                dist_factor = dist * dist;
-            }
+        const tripoint &pos = sound_event_pair.first;
+        const float volume = static_cast<float>( sound_event_pair.second );
+        const auto inserted = cluster_of_submap.emplace( ms_to_sm_copy( pos ), sound_clusters.size() );
+        if( inserted.second ) {
+            // The volume and cluster weight are the same for the first element.
+            sound_clusters.push_back( {
+                static_cast<float>( pos.x ), static_cast<float>( pos.y ), static_cast<float>( pos.z ),
+                volume, volume
+            } );
+            continue;
+        }
+        centroid &found_centroid = sound_clusters[inserted.first->second];
+        const float volume_sum = volume + found_centroid.weight;
+        if( volume_sum > 0 ) {
+            // Set the centroid location to the average of the two locations, weighted by volume.
+            found_centroid.x = ( pos.x * volume + found_centroid.x * found_centroid.weight ) / volume_sum;
+            found_centroid.y = ( pos.y * volume + found_centroid.y * found_centroid.weight ) / volume_sum;
+            found_centroid.z = ( pos.z * volume + found_centroid.z * found_centroid.weight ) / volume_sum;
         }
-        const float volume_sum = static_cast<float>( sound_event_pair.second ) + found_centroid->weight;
-        // Set the centroid location to the average of the two locations, weighted by volume.
-        found_centroid->x = static_cast<float>( ( sound_event_pair.first.x * sound_event_pair.second ) +
-                                                ( found_centroid->x * found_centroid->weight ) ) / volume_sum;
-        found_centroid->y = static_cast<float>( ( sound_event_pair.first.y * sound_event_pair.second ) +
-                                                ( found_centroid->y * found_centroid->weight ) ) / volume_sum;
-        found_centroid->z = static_cast<float>( ( sound_event_pair.first.z * sound_event_pair.second ) +
-                                                ( found_centroid->z * found_centroid->weight ) ) / volume_sum;
         // Set the centroid volume to the larger of the volumes.
-        found_centroid->volume = std::max( found_centroid->volume,
-                                           static_cast<float>( sound_event_pair.second ) );
+        found_centroid.volume = std::max( found_centroid.volume, volume );
         // Set the centroid weight to the sum of the weights.
-        found_centroid->weight = volume_sum;
+        found_centroid.weight = volume_sum;
     }
     return sound_clusters;
 }
@@ -265,7 +243,7 @@ static int get_signal_for_hordes( const centroid &centr )
 
 void sounds::process_sounds()
 {
-    std::vector<centroid> sound_clusters = cluster_sounds( recent_sounds );
+    const std::vector<centroid> &sound_clusters = cluster_sounds( recent_sounds );
     const int weather_vol = weather::sound_attn( g->weather.weather );
     for( const auto &this_centroid : sound_clusters ) {
         // Since monsters don't go deaf ATM we can just use the weather modified volume
@@ -284,13 +262,10 @@ void sounds::process_sounds()
             overmap_buffer.signal_hordes( target, sig_power );
         }
         // Alert all monsters (that can hear) to the sound.
-        for( monster &critter : g->all_monsters() ) {
+        // Monsters further away than twice the volume certainly won't hear the sound.
+        for( monster *critter : g->critter_tracker->find_in_radius( source, vol * 2 - 1 ) ) {
             // TODO: Generalize this to Creature::hear_sound
-            const int dist = rl_dist( source, critter.pos() );
-            if( vol * 2 > dist ) {
-                // Exclude monsters that certainly won't hear the sound
-                critter.hear_sound( source, vol, dist );
-            }
+            critter->hear_sound( source, vol, rl_dist( source, critter->pos() ) );
         }
     }
     recent_sounds.clear();
@@ -539,7 +514,7 @@ std::vector<tripoint> sounds::get_footstep_markers()
 
 std::pair<std::vector<tripoint>, std::vector<tripoint>> sounds::get_monster_sounds()
 {
-    auto sound_clusters = cluster_sounds( recent_sounds );
+    const std::vector<centroid> &sound_clusters = cluster_sounds( recent_sounds );
     std::vector<tripoint> sound_locations;
     sound_locations.reserve( recent_sounds.size() );
     for( const auto &sound : recent_sounds ) {
@@ -15,8 +15,12 @@ void maptile_soa<sx, sy>::swap_soa_tile( const point &p1, const point &p2 )
     std::swap( ter[p1.x][p1.y], ter[p2.x][p2.y] );
     std::swap( frn[p1.x][p1.y], frn[p2.x][p2.y] );
     std::swap( lum[p1.x][p1.y], lum[p2.x][p2.y] );
-    std::swap( itm[p1.x][p1.y], itm[p2.x][p2.y] );
-    std::swap( fld[p1.x][p1.y], fld[p2.x][p2.y] );
+    std::unique_ptr<cata::colony<item>> items = itm.release( p1 );
+    itm.reset( p1, itm.release( p2 ) );
+    itm.reset( p2, std::move( items ) );
+    std::unique_ptr<field> fields = fld.release( p1 );
+    fld.reset( p1, fld.release( p2 ) );
+    fld.reset( p2, std::move( fields ) );
     std::swap( trp[p1.x][p1.y], trp[p2.x][p2.y] );
     std::swap( rad[p1.x][p1.y], rad[p2.x][p2.y] );
 }
@@ -27,8 +31,12 @@ void maptile_soa<sx, sy>::swap_soa_tile( const point &p, maptile_soa<1, 1> &othe
     std::swap( ter[p.x][p.y], **other.ter );
     std::swap( frn[p.x][p.y], **other.frn );
     std::swap( lum[p.x][p.y], **other.lum );
-    std::swap( itm[p.x][p.y], **other.itm );
-    std::swap( fld[p.x][p.y], **other.fld );
+    std::unique_ptr<cata::colony<item>> items = itm.release( p );
+    itm.reset( p, other.itm.release( point_zero ) );
+    other.itm.reset( point_zero, std::move( items ) );
+    std::unique_ptr<field> fields = fld.release( p );
+    fld.reset( p, other.fld.release( point_zero ) );
+    other.fld.reset( point_zero, std::move( fields ) );
     std::swap( trp[p.x][p.y], **other.trp );
     std::swap( rad[p.x][p.y], **other.rad );
 }
@@ -220,6 +228,17 @@ bool submap::contains_vehicle( vehicle *veh )
     return match != vehicles.end();
 }
 
+void submap::release_empty_tiles()
+{
+    itm.release_if( []( const cata::colony<item> &items ) {
+        return items.empty();
+    } );
+    fld.release_if( []( const field &fields ) {
+        return fields.field_count() == 0;
+    } );
+    emptied_tiles = false;
+}
+
 void submap::rotate( int turns )
 {
     turns = turns % 4;
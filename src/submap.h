@@ -2,6 +2,7 @@
 #ifndef SUBMAP_H
 #define SUBMAP_H
 
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -45,13 +46,121 @@ struct spawn_point {
         mission_id( MIS ), friendly( F ), name( N ) {}
 };
 
+/**
+ * Objects that only some tiles of a submap have, like items or fields. An occupancy bitmap
+ * tells which tiles have one, only the objects of those tiles are stored (in tile order).
+ * Adding or releasing objects doesn't move the others, so references to an object stay
+ * valid until it is released.
+ */
+template<typename T, int sx, int sy>
+class sparse_tile_storage
+{
+    public:
+        sparse_tile_storage() = default;
+        sparse_tile_storage( const sparse_tile_storage &other ) {
+            *this = other;
+        }
+        sparse_tile_storage( sparse_tile_storage && ) = default;
+        sparse_tile_storage &operator=( const sparse_tile_storage &other ) {
+            occupied = other.occupied;
+            objects.clear();
+            objects.reserve( other.objects.size() );
+            for( const std::unique_ptr<T> &obj : other.objects ) {
+                objects.push_back( std::make_unique<T>( *obj ) );
+            }
+            return *this;
+        }
+        sparse_tile_storage &operator=( sparse_tile_storage && ) = default;
+
+        /** The object of the tile, an empty one is added if the tile has none yet. */
+        T &get( const point &p ) {
+            const size_t i = index( p );
+            const size_t pos = rank( i );
+            if( !occupied[i] ) {
+                occupied.set( i );
+                objects.insert( objects.begin() + pos, std::make_unique<T>() );
+            }
+            return *objects[pos];
+        }
+        /** The object of the tile, or a shared empty one if the tile has none. */
+        const T &peek( const point &p ) const {
+            static const T nothing;
+            const T *const obj = find( p );
+            return obj != nullptr ? *obj : nothing;
+        }
+        /** The object of the tile, nullptr if the tile has none. */
+        T *find( const point &p ) {
+            const size_t i = index( p );
+            return occupied[i] ? objects[rank( i )].get() : nullptr;
+        }
+        const T *find( const point &p ) const {
+            const size_t i = index( p );
+            return occupied[i] ? objects[rank( i )].get() : nullptr;
+        }
+
+        /** Takes the object out of the tile, nullptr if the tile has none. */
+        std::unique_ptr<T> release( const point &p ) {
+            const size_t i = index( p );
+            if( !occupied[i] ) {
+                return nullptr;
+            }
+            const auto iter = objects.begin() + rank( i );
+            std::unique_ptr<T> result = std::move( *iter );
+            objects.erase( iter );
+            occupied.reset( i );
+            return result;
+        }
+        /** Replaces the object of the tile, nullptr leaves the tile without one. */
+        void reset( const point &p, std::unique_ptr<T> obj ) {
+            release( p );
+            if( obj ) {
+                const size_t i = index( p );
+                objects.insert( objects.begin() + rank( i ), std::move( obj ) );
+                occupied.set( i );
+            }
+        }
+        /** Releases the objects of all tiles for which @p is_empty returns true. */
+        template<typename Predicate>
+        void release_if( Predicate is_empty ) {
+            size_t pos = 0;
+            for( size_t i = 0; i < sx * sy; i++ ) {
+                if( !occupied[i] ) {
+                    continue;
+                }
+                if( is_empty( *objects[pos] ) ) {
+                    objects.erase( objects.begin() + pos );
+                    occupied.reset( i );
+                } else {
+                    pos++;
+                }
+            }
+        }
+
+        /** Number of tiles that have an object. */
+        size_t size() const {
+            return objects.size();
+        }
+
+    private:
+        static size_t index( const point &p ) {
+            return p.x * sy + p.y;
+        }
+        /** Number of objects stored for the tiles before tile @p i. */
+        size_t rank( const size_t i ) const {
+            return ( occupied << ( sx * sy - i ) ).count();
+        }
+
+        std::bitset<sx * sy> occupied;
+        std::vector<std::unique_ptr<T>> objects;
+};
+
 template<int sx, int sy>
 struct maptile_soa {
     ter_id             ter[sx][sy];  // Terrain on each square
     furn_id            frn[sx][sy];  // Furniture on each square
     std::uint8_t       lum[sx][sy];  // Number of items emitting light on each square
-    cata::colony<item> itm[sx][sy];  // Items on each square
-    field              fld[sx][sy];  // Field on each square
+    sparse_tile_storage<cata::colony<item>, sx, sy> itm; // Items on the squares that have some
+    sparse_tile_storage<field, sx, sy> fld; // Fields on the squares that have some
     trap_id            trp[sx][sy];  // Trap on each square
     int                rad[sx][sy];  // Irradiation of each square
 
@@ -119,7 +228,7 @@ class submap : public maptile_soa<SEEX, SEEY>    // TODO: Use private inheritanc
             // Have to scan through all items to be sure removing i will actually lower
             // the count below 255.
             int count = 0;
-            for( const auto &it : itm[p.x][p.y] ) {
+            for( const auto &it : itm.peek( p ) ) {
                 if( it.is_emissive() ) {
                     count++;
                 }
@@ -178,6 +287,9 @@ class submap : public maptile_soa<SEEX, SEEY>    // TODO: Use private inheritanc
 
         bool contains_vehicle( vehicle * );
 
+        /** Drops the item and field storage of tiles where it is empty. */
+        void release_empty_tiles();
+
         void rotate( int turns );
 
         void store( JsonOut &jsout ) const;
@@ -192,6 +304,11 @@ class submap : public maptile_soa<SEEX, SEEY>    // TODO: Use private inheritanc
         active_item_cache active_items;
 
         int field_count = 0;
+        /**
+         * Whether items or fields were removed, or storage was handed out for a tile without
+         * any, since the last @ref release_empty_tiles.
+         */
+        bool emptied_tiles = false;
         time_point last_touched = calendar::turn_zero;
         std::vector<spawn_point> spawns;
         /**
@@ -256,16 +373,17 @@ struct maptile {
         }
 
         const field &get_field() const {
-            return sm->fld[x][y];
+            return sm->fld.peek( pos() );
         }
 
         field_entry *find_field( const field_type_id field_to_find ) {
-            return sm->fld[x][y].find_field( field_to_find );
+            field *const fields = sm->fld.find( pos() );
+            return fields != nullptr ? fields->find_field( field_to_find ) : nullptr;
         }
 
         bool add_field( const field_type_id field_to_add, const int new_intensity,
                         const time_duration &new_age ) {
-            const bool ret = sm->fld[x][y].add_field( field_to_add, new_intensity, new_age );
+            const bool ret = sm->fld.get( pos() ).add_field( field_to_add, new_intensity, new_age );
             if( ret ) {
                 sm->field_count++;
             }
@@ -295,12 +413,12 @@ struct maptile {
 
         // For map::draw_maptile
         size_t get_item_count() const {
-            return sm->itm[x][y].size();
+            return sm->itm.peek( pos() ).size();
         }
 
         // Assumes there is at least one item
         const item &get_uppermost_item() const {
-            return *std::prev( sm->itm[x][y].cend() );
+            return *std::prev( sm->itm.peek( pos() ).cend() );
         }
 };
 
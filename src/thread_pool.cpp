@@ -0,0 +1,113 @@
+#include "thread_pool.h"
+
+#include <exception>
+#include <memory>
+#include <utility>
+
+#include "options.h"
+
+thread_pool::thread_pool( const int workers )
+{
+    for( int i = 0; i < workers; ++i ) {
+        threads.emplace_back( &thread_pool::work, this );
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    wake_workers.notify_all();
+    for( std::thread &t : threads ) {
+        t.join();
+    }
+}
+
+void thread_pool::run( const int jobs, const std::function<void( int )> &job )
+{
+    if( jobs <= 0 ) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock( mutex );
+    batch = &job;
+    next_job = 0;
+    job_count = jobs;
+    unfinished_jobs = jobs;
+    ++batch_number;
+    wake_workers.notify_all();
+
+    run_jobs( lock );
+    batch_done.wait( lock, [this] {
+        return unfinished_jobs == 0;
+    } );
+    batch = nullptr;
+    if( batch_error ) {
+        std::exception_ptr error;
+        std::swap( error, batch_error );
+        std::rethrow_exception( error );
+    }
+}
+
+void thread_pool::run_jobs( std::unique_lock<std::mutex> &lock )
+{
+    while( next_job < job_count ) {
+        const int current = next_job++;
+        const std::function<void( int )> &job = *batch;
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            job( current );
+        } catch( ... ) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if( error && !batch_error ) {
+            batch_error = error;
+        }
+        if( --unfinished_jobs == 0 ) {
+            batch_done.notify_all();
+        }
+    }
+}
+
+void thread_pool::work()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    unsigned int last_batch = batch_number;
+    while( true ) {
+        wake_workers.wait( lock, [this, last_batch] {
+            return stopping || batch_number != last_batch;
+        } );
+        if( stopping ) {
+            return;
+        }
+        last_batch = batch_number;
+        run_jobs( lock );
+    }
+}
+
+thread_pool *get_worker_threads()
+{
+    static std::unique_ptr<thread_pool> pool;
+    const int wanted = get_option<int>( "WORKER_THREADS" );
+    if( wanted <= 0 ) {
+        pool.reset();
+    } else if( !pool || pool->size() != wanted + 1 ) {
+        pool = std::make_unique<thread_pool>( wanted );
+    }
+    return pool.get();
+}
+
+void parallel_for( const int jobs, const std::function<void( int )> &job )
+{
+    thread_pool *const pool = get_worker_threads();
+    if( pool == nullptr || jobs <= 1 ) {
+        for( int i = 0; i < jobs; ++i ) {
+            job( i );
+        }
+        return;
+    }
+    pool->run( jobs, job );
+}
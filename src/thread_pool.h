@@ -0,0 +1,76 @@
+#pragma once
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+/**
+ * A fixed set of worker threads that run batches of independent jobs.
+ *
+ * The thread calling @ref run takes part in the work and only returns once every
+ * job of the batch is finished, so jobs may freely use data owned by the caller.
+ * Jobs must not touch game state that isn't safe to use concurrently (debugmsg, rng,
+ * the message log, lazily filled caches...).
+ */
+class thread_pool
+{
+    public:
+        /** Starts @p workers threads in addition to the calling thread. */
+        explicit thread_pool( int workers );
+        ~thread_pool();
+
+        thread_pool( const thread_pool & ) = delete;
+        thread_pool &operator=( const thread_pool & ) = delete;
+
+        /** Number of threads taking part in @ref run, including the calling one. */
+        int size() const {
+            return static_cast<int>( threads.size() ) + 1;
+        }
+
+        /**
+         * Calls job( 0 ) ... job( jobs - 1 ), in no particular order, and waits for all of them.
+         * If jobs throw, the first exception is rethrown once the whole batch is finished.
+         */
+        void run( int jobs, const std::function<void( int )> &job );
+
+    private:
+        void work();
+        // Takes and runs jobs of the current batch until there are none left. Expects the lock held.
+        void run_jobs( std::unique_lock<std::mutex> &lock );
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake_workers;
+        std::condition_variable batch_done;
+        const std::function<void( int )> *batch = nullptr;
+        // First exception thrown by a job of the current batch.
+        std::exception_ptr batch_error;
+        int next_job = 0;
+        int job_count = 0;
+        int unfinished_jobs = 0;
+        unsigned int batch_number = 0;
+        bool stopping = false;
+};
+
+/**
+ * The shared pool, sized by the WORKER_THREADS option.
+ * Returns nullptr if no worker threads are enabled.
+ */
+thread_pool *get_worker_threads();
+
+/**
+ * Calls job( 0 ) ... job( jobs - 1 ) on the shared worker threads, or in order on the
+ * calling thread if there are none. Returns once all jobs are finished.
+ */
+void parallel_for( int jobs, const std::function<void( int )> &job );
+
+#endif
@@ -12,6 +12,7 @@
 #include <queue>
 #include <set>
 #include <sstream>
+#include <tuple>
 #include <unordered_map>
 #include <memory>
 #include <list>
@@ -235,7 +236,10 @@ vehicle::vehicle() : vehicle( vproto_id() )
     sm_pos = tripoint_zero;
 }
 
-vehicle::~vehicle() = default;
+vehicle::~vehicle()
+{
+    invalidate_power_grids();
+}
 
 bool vehicle::player_in_control( const player &p ) const
 {
@@ -2518,9 +2522,9 @@ std::vector<int> vehicle::parts_at_relative( const point &dp,
         }
         return res;
     } else {
-        const auto &iter = relative_parts.find( dp );
-        if( iter != relative_parts.end() ) {
-            return iter->second;
+        const std::vector<int> *parts_here = parts_at_mount( dp );
+        if( parts_here != nullptr ) {
+            return *parts_here;
         } else {
             std::vector<int> res;
             return res;
@@ -2528,6 +2532,17 @@ std::vector<int> vehicle::parts_at_relative( const point &dp,
     }
 }
 
+const std::vector<int> *vehicle::parts_at_mount( const point &dp ) const
+{
+    const point offset = dp - relative_parts_min;
+    if( offset.x < 0 || offset.y < 0 || offset.x >= relative_parts_width ||
+        static_cast<size_t>( offset.y * relative_parts_width + offset.x ) >= relative_parts.size() ) {
+        return nullptr;
+    }
+    const std::vector<int> &parts_here = relative_parts[offset.y * relative_parts_width + offset.x];
+    return parts_here.empty() ? nullptr : &parts_here;
+}
+
 cata::optional<vpart_reference> vpart_position::obstacle_at_part() const
 {
     const cata::optional<vpart_reference> part = part_with_feature( VPFLAG_OBSTACLE, true );
@@ -2598,10 +2613,8 @@ int vehicle::part_with_feature( int part, vpart_bitflags const flag, bool unbrok
     if( part_flag( part, flag ) && ( !unbroken || !parts[part].is_broken() ) ) {
         return part;
     }
-    const auto it = relative_parts.find( parts[part].mount );
-    if( it != relative_parts.end() ) {
-        const std::vector<int> &parts_here = it->second;
-        for( auto &i : parts_here ) {
+    if( const std::vector<int> *parts_here = parts_at_mount( parts[part].mount ) ) {
+        for( auto &i : *parts_here ) {
             if( part_flag( i, flag ) && ( !unbroken || !parts[i].is_broken() ) ) {
                 return i;
             }
@@ -3699,7 +3712,7 @@ void vehicle::spew_field( double joules, int part, field_type_id type, int inten
     point p = parts[part].mount;
     intensity = std::max( joules / 10000, static_cast<double>( intensity ) );
     // Move back from engine/muffler until we find an open space
-    while( relative_parts.find( p ) != relative_parts.end() ) {
+    while( parts_at_mount( p ) != nullptr ) {
         p.x += ( velocity < 0 ? 1 : -1 );
     }
     point q = coord_translate( p );
@@ -4727,74 +4740,115 @@ vehicle *vehicle::find_vehicle( const tripoint &where )
     return nullptr;
 }
 
-template <typename Func, typename Vehicle>
-int vehicle::traverse_vehicle_graph( Vehicle *start_veh, int amount, Func action )
+unsigned int vehicle::power_grid_changes = 0;
+
+void vehicle::invalidate_power_grids()
 {
-    // Breadth-first search! Initialize the queue with a pointer to ourselves and go!
-    std::queue< std::pair<Vehicle *, int> > connected_vehs;
-    std::set<Vehicle *> visited_vehs;
-    connected_vehs.push( std::make_pair( start_veh, 0 ) );
+    power_grid_changes++;
+}
 
-    while( amount > 0 && !connected_vehs.empty() ) {
-        auto current_node = connected_vehs.front();
-        Vehicle *current_veh = current_node.first;
-        int current_loss = current_node.second;
+const std::vector<std::pair<vehicle *, int>> &vehicle::get_power_grid() const
+{
+    if( power_grid_generation == power_grid_changes ) {
+        return power_grid;
+    }
 
-        visited_vehs.insert( current_veh );
-        connected_vehs.pop();
+    power_grid.clear();
+    // Breadth-first search! Initialize the queue with a pointer to ourselves and go!
+    std::queue< std::pair<const vehicle *, int> > connected_vehs;
+    std::set<const vehicle *> visited_vehs = { this };
+    connected_vehs.push( std::make_pair( this, 0 ) );
 
-        g->u.add_msg_if_player( m_debug, "Traversing graph with %d power", amount );
+    while( !connected_vehs.empty() ) {
+        const vehicle *current_veh = connected_vehs.front().first;
+        const int current_loss = connected_vehs.front().second;
+        connected_vehs.pop();
 
-        for( auto &p : current_veh->loose_parts ) {
+        for( const int p : current_veh->loose_parts ) {
             if( !current_veh->part_info( p ).has_flag( "POWER_TRANSFER" ) ) {
                 continue; // ignore loose parts that aren't power transfer cables
             }
 
-            auto target_veh = vehicle::find_vehicle( current_veh->parts[p].target.second );
-            if( target_veh == nullptr || visited_vehs.count( target_veh ) > 0 ) {
+            vehicle *target_veh = vehicle::find_vehicle( current_veh->parts[p].target.second );
+            if( target_veh == nullptr || !visited_vehs.insert( target_veh ).second ) {
                 // Either no destination here (that vehicle's rolled away or off-map) or
                 // we've already looked at that vehicle.
                 continue;
             }
 
-            // Add this connected vehicle to the queue of vehicles to search next,
-            // but only if we haven't seen this one before.
-            if( visited_vehs.count( target_veh ) < 1 ) {
-                int target_loss = current_loss + current_veh->part_info( p ).epower;
-                connected_vehs.push( std::make_pair( target_veh, target_loss ) );
+            const int target_loss = current_loss + current_veh->part_info( p ).epower;
+            connected_vehs.push( std::make_pair( target_veh, target_loss ) );
+            power_grid.emplace_back( target_veh, target_loss );
+        }
+    }
 
-                float loss_amount = ( static_cast<float>( amount ) * static_cast<float>( target_loss ) ) / 100;
-                g->u.add_msg_if_player( m_debug, "Visiting remote %p with %d power (loss %f, which is %d percent)",
-                                        static_cast<void *>( target_veh ), amount, loss_amount, target_loss );
+    // Finding the vehicles may have loaded their submaps, which invalidates the grids.
+    power_grid_generation = power_grid_changes;
+    return power_grid;
+}
 
-                amount = action( target_veh, amount, static_cast<int>( loss_amount ) );
-                g->u.add_msg_if_player( m_debug, "After remote %p, %d power", static_cast<void *>( target_veh ),
-                                        amount );
+template <typename Func, typename Vehicle>
+int vehicle::traverse_vehicle_graph( Vehicle *start_veh, int amount, Func action )
+{
+    g->u.add_msg_if_player( m_debug, "Traversing graph with %d power", amount );
 
-                if( amount < 1 ) {
-                    break; // No more charge to donate away.
-                }
-            }
+    for( const auto &node : start_veh->get_power_grid() ) {
+        if( amount < 1 ) {
+            break; // No more charge to donate away.
         }
+        Vehicle *target_veh = node.first;
+        const int target_loss = node.second;
+
+        float loss_amount = ( static_cast<float>( amount ) * static_cast<float>( target_loss ) ) / 100;
+        g->u.add_msg_if_player( m_debug, "Visiting remote %p with %d power (loss %f, which is %d percent)",
+                                static_cast<const void *>( target_veh ), amount, loss_amount, target_loss );
+
+        amount = action( target_veh, amount, static_cast<int>( loss_amount ) );
+        g->u.add_msg_if_player( m_debug, "After remote %p, %d power",
+                                static_cast<const void *>( target_veh ), amount );
     }
     return amount;
 }
 
+namespace
+{
+// A battery keyed by its charge percentage. Batteries at the same percentage are ordered by
+// when they were added, so the heaps below level them like a std::multimap would.
+struct battery_level {
+    int percent;
+    int order;
+    vehicle_part *part;
+};
+
+bool operator<( const battery_level &lhs, const battery_level &rhs )
+{
+    return std::tie( lhs.percent, lhs.order ) < std::tie( rhs.percent, rhs.order );
+}
+} // namespace
+
 int vehicle::charge_battery( int amount, bool include_other_vehicles )
 {
-    // Key parts by percentage charge level.
-    std::multimap<int, vehicle_part *> chargeable_parts;
-    for( vehicle_part &p : parts ) {
-        if( p.is_available() && p.is_battery() && p.ammo_capacity() > p.ammo_remaining() ) {
-            chargeable_parts.insert( { ( p.ammo_remaining() * 100 ) / p.ammo_capacity(), &p } );
+    // Heap of the parts by percentage charge level, emptiest first. The storage is reused
+    // between calls, this runs for every vehicle every turn.
+    static thread_local std::vector<battery_level> chargeable_parts;
+    chargeable_parts.clear();
+    int order = 0;
+    for( const int b : batteries ) {
+        vehicle_part &p = parts[b];
+        if( p.is_available() && p.ammo_capacity() > p.ammo_remaining() ) {
+            chargeable_parts.push_back( { ( p.ammo_remaining() * 100 ) / p.ammo_capacity(), order++, &p } );
         }
     }
+    const auto emptier = []( const battery_level & lhs, const battery_level & rhs ) {
+        return rhs < lhs;
+    };
+    std::make_heap( chargeable_parts.begin(), chargeable_parts.end(), emptier );
     while( amount > 0 && !chargeable_parts.empty() ) {
         // Grab first part, charge until it reaches the next %, then re-insert with new % key.
-        auto iter = chargeable_parts.begin();
-        int charge_level = iter->first;
-        vehicle_part *p = iter->second;
-        chargeable_parts.erase( iter );
+        std::pop_heap( chargeable_parts.begin(), chargeable_parts.end(), emptier );
+        int charge_level = chargeable_parts.back().percent;
+        vehicle_part *p = chargeable_parts.back().part;
+        chargeable_parts.pop_back();
         // Calculate number of charges to reach the next %, but insure it's at least
         // one more than current charge.
         int next_charge_level = ( ( charge_level + 1 ) * p->ammo_capacity() ) / 100;
@@ -4803,7 +4857,8 @@ int vehicle::charge_battery( int amount, bool include_other_vehicles )
         p->ammo_set( fuel_type_battery, p->ammo_remaining() + qty );
         amount -= qty;
         if( p->ammo_capacity() > p->ammo_remaining() ) {
-            chargeable_parts.insert( { ( p->ammo_remaining() * 100 ) / p->ammo_capacity(), p } );
+            chargeable_parts.push_back( { ( p->ammo_remaining() * 100 ) / p->ammo_capacity(), order++, p } );
+            std::push_heap( chargeable_parts.begin(), chargeable_parts.end(), emptier );
         }
     }
 
@@ -4821,26 +4876,31 @@ int vehicle::charge_battery( int amount, bool include_other_vehicles )
 
 int vehicle::discharge_battery( int amount, bool recurse )
 {
-    // Key parts by percentage charge level.
-    std::multimap<int, vehicle_part *> dischargeable_parts;
-    for( vehicle_part &p : parts ) {
-        if( p.is_available() && p.is_battery() && p.ammo_remaining() > 0 ) {
-            dischargeable_parts.insert( { ( p.ammo_remaining() * 100 ) / p.ammo_capacity(), &p } );
+    // Heap of the parts by percentage charge level, fullest first, see charge_battery.
+    static thread_local std::vector<battery_level> dischargeable_parts;
+    dischargeable_parts.clear();
+    int order = 0;
+    for( const int b : batteries ) {
+        vehicle_part &p = parts[b];
+        if( p.is_available() && p.ammo_remaining() > 0 ) {
+            dischargeable_parts.push_back( { ( p.ammo_remaining() * 100 ) / p.ammo_capacity(), order++, &p } );
         }
     }
+    std::make_heap( dischargeable_parts.begin(), dischargeable_parts.end() );
     while( amount > 0 && !dischargeable_parts.empty() ) {
         // Grab first part, discharge until it reaches the next %, then re-insert with new % key.
-        auto iter = std::prev( dischargeable_parts.end() );
-        int charge_level = iter->first;
-        vehicle_part *p = iter->second;
-        dischargeable_parts.erase( iter );
+        std::pop_heap( dischargeable_parts.begin(), dischargeable_parts.end() );
+        int charge_level = dischargeable_parts.back().percent;
+        vehicle_part *p = dischargeable_parts.back().part;
+        dischargeable_parts.pop_back();
         // Calculate number of charges to reach the previous %.
         int prev_charge_level = ( ( charge_level - 1 ) * p->ammo_capacity() ) / 100;
         int amount_to_discharge = std::min( p->ammo_remaining() - prev_charge_level, amount );
         p->ammo_consume( amount_to_discharge, global_part_pos3( *p ) );
         amount -= amount_to_discharge;
         if( p->ammo_remaining() > 0 ) {
-            dischargeable_parts.insert( { ( p->ammo_remaining() * 100 ) / p->ammo_capacity(), p } );
+            dischargeable_parts.push_back( { ( p->ammo_remaining() * 100 ) / p->ammo_capacity(), order++, p } );
+            std::push_heap( dischargeable_parts.begin(), dischargeable_parts.end() );
         }
     }
 
@@ -5223,12 +5283,8 @@ void vehicle::gain_moves()
     }
 
     // Force off-map vehicles to load by visiting them every time we gain moves.
-    // Shouldn't be too expensive if there aren't fifty trillion vehicles in the graph...
-    // ...and if there are, it's the player's fault for putting them there.
-    auto nil_visitor = []( vehicle *, int amount, int ) {
-        return amount;
-    };
-    traverse_vehicle_graph( this, 1, nil_visitor );
+    // The grid is cached, so this only loads anything after vehicles changed.
+    get_power_grid();
 
     if( check_environmental_effects ) {
         check_environmental_effects = do_environmental_effects();
@@ -5284,6 +5340,7 @@ void vehicle::refresh()
         return;
     }
 
+    invalidate_power_grids();
     alternators.clear();
     engines.clear();
     reactors.clear();
@@ -5300,6 +5357,7 @@ void vehicle::refresh()
     steering.clear();
     speciality.clear();
     floating.clear();
+    batteries.clear();
     alternator_load = 0;
     extra_drag = 0;
     all_wheels_on_one_axis = true;
@@ -5325,6 +5383,20 @@ void vehicle::refresh()
 
     bool refresh_done = false;
 
+    // The grid of parts at each point covers the bounding box of all mount points.
+    for( const vehicle_part &part : parts ) {
+        if( !part.removed ) {
+            mount_min.x = std::min( mount_min.x, part.mount.x );
+            mount_min.y = std::min( mount_min.y, part.mount.y );
+            mount_max.x = std::max( mount_max.x, part.mount.x );
+            mount_max.y = std::max( mount_max.y, part.mount.y );
+        }
+    }
+    relative_parts_min = mount_min;
+    relative_parts_width = std::max( mount_max.x - mount_min.x + 1, 0 );
+    relative_parts.resize( static_cast<size_t>( relative_parts_width ) *
+                           std::max( mount_max.y - mount_min.y + 1, 0 ) );
+
     // Main loop over all vehicle parts.
     for( const vpart_reference &vp : get_all_parts() ) {
         const size_t p = vp.part_index();
@@ -5334,22 +5406,21 @@ void vehicle::refresh()
         }
         refresh_done = true;
 
-        // Build map of point -> all parts in that point
+        // Build grid of point -> all parts in that point
         const point pt = vp.mount();
-        mount_min.x = std::min( mount_min.x, pt.x );
-        mount_min.y = std::min( mount_min.y, pt.y );
-        mount_max.x = std::max( mount_max.x, pt.x );
-        mount_max.y = std::max( mount_max.y, pt.y );
-
+        std::vector<int> &parts_here = relative_parts[( pt.y - relative_parts_min.y ) *
+                                                    relative_parts_width + pt.x - relative_parts_min.x];
         // This will keep the parts at point pt sorted
-        std::vector<int>::iterator vii = std::lower_bound( relative_parts[pt].begin(),
-                                         relative_parts[pt].end(),
+        std::vector<int>::iterator vii = std::lower_bound( parts_here.begin(), parts_here.end(),
                                          static_cast<int>( p ), svpv );
-        relative_parts[pt].insert( vii, p );
+        parts_here.insert( vii, p );
 
         if( vpi.has_flag( VPFLAG_FLOATS ) ) {
             floating.push_back( p );
         }
+        if( vp.part().is_battery() ) {
+            batteries.push_back( p );
+        }
 
         if( vp.part().is_unavailable() ) {
             continue;
@@ -6182,8 +6253,12 @@ void vehicle::update_time( const time_point &update_to )
     if( funnels.empty() && solar_panels.empty() && wind_turbines.empty() && water_wheels.empty() ) {
         return;
     }
-    // Get one weather data set per vehicle, they don't differ much across vehicle area
-    auto accum_weather = sum_conditions( update_from, update_to, g->m.getabs( global_pos3() ) );
+    // Get one weather data set per vehicle, they don't differ much across vehicle area.
+    // Only funnels and solar panels need it, the others use the current conditions.
+    weather_sum accum_weather;
+    if( !funnels.empty() || !solar_panels.empty() ) {
+        accum_weather = sum_conditions( update_from, update_to, g->m.getabs( global_pos3() ) );
+    }
     // make some reference objects to use to check for reload
     const item water( "water" );
     const item water_clean( "water_clean" );
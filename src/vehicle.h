@@ -694,6 +694,13 @@ class vehicle
          */
         template <typename Func, typename Vehicle>
         static int traverse_vehicle_graph( Vehicle *start_veh, int amount, Func action );
+
+        /**
+         * The vehicles connected to this one by POWER_TRANSFER parts, in the order of a
+         * breadth-first search, each with the transfer loss in percent along the way there.
+         * Kept until @ref invalidate_power_grids is called.
+         */
+        const std::vector<std::pair<vehicle *, int>> &get_power_grid() const;
     public:
         vehicle( const vproto_id &type_id, int init_veh_fuel = -1, int init_veh_status = -1 );
         vehicle();
@@ -903,6 +910,8 @@ class vehicle
 
         // returns the list of indices of parts at certain position (not accounting frame direction)
         std::vector<int> parts_at_relative( const point &dp, bool use_cache ) const;
+        /** The parts at a mount point as cached by refresh(), nullptr if there are none. */
+        const std::vector<int> *parts_at_mount( const point &dp ) const;
 
         // returns index of part, inner to given, with certain flag, or -1
         int part_with_feature( int p, const std::string &f, bool unbroken ) const;
@@ -1108,6 +1117,12 @@ class vehicle
         int total_accessory_epower_w() const;
         // Net power draw or drain on batteries.
         int net_battery_charge_rate_w() const;
+
+        /**
+         * Makes all vehicles look for the vehicles connected to them again. Must be called
+         * whenever a vehicle is created, destroyed, moved or changes its parts.
+         */
+        static void invalidate_power_grids();
         // Maximum available power available from all reactors. Power from
         // reactors is only drawn when batteries are empty.
         int max_reactor_epower_w() const;
@@ -1623,6 +1638,7 @@ class vehicle
         // List of parts that will not be on a vehicle very often, or which only one will be present
         std::vector<int> speciality;
         std::vector<int> floating;         // List of parts that provide buoyancy to boats
+        std::vector<int> batteries;        // List of batteries, including unavailable ones
 
         // config values
         std::string name;   // vehicle name
@@ -1632,8 +1648,12 @@ class vehicle
          * spawned with the default constructor).
          */
         vproto_id type;
-        // parts_at_relative(dp) is used a lot (to put it mildly)
-        std::map<point, std::vector<int>> relative_parts;
+        // parts_at_relative(dp) is used a lot (to put it mildly), so the parts at each mount
+        // point are kept in a grid over the bounding box of the mount points, row by row.
+        // Use parts_at_mount to look them up.
+        std::vector<std::vector<int>> relative_parts;
+        point relative_parts_min;
+        int relative_parts_width = 0;
         std::set<label> labels;            // stores labels
         std::set<std::string> tags;        // Properties of the vehicle
         // After fuel consumption, this tracks the remainder of fuel < 1, and applies it the next time.
@@ -1725,6 +1745,12 @@ class vehicle
     private:
         bool no_refresh = false;
 
+        // Cache of get_power_grid, valid while power_grid_generation == power_grid_changes.
+        mutable std::vector<std::pair<vehicle *, int>> power_grid;
+        // Unsigned, the counter is bumped all the time and may wrap around.
+        mutable unsigned int power_grid_generation = UINT_MAX;
+        static unsigned int power_grid_changes;
+
         // if true, pivot_cache needs to be recalculated
         mutable bool pivot_dirty;
         mutable bool mass_dirty = true;
@@ -158,9 +158,16 @@ bool visitable<T>::has_quality( const quality_id &qual, int level, int qty ) con
 template <>
 bool visitable<inventory>::has_quality( const quality_id &qual, int level, int qty ) const
 {
+    const auto &index = static_cast<const inventory *>( this )->get_quality_index();
+    const auto iter = index.find( qual );
+    if( iter == index.end() ) {
+        return false;
+    }
+
     int res = 0;
-    for( const auto &stack : static_cast<const inventory *>( this )->items ) {
-        res += stack.size() * has_quality_internal( stack.front(), qual, level, qty );
+    for( auto level_iter = iter->second.lower_bound( level ); level_iter != iter->second.end();
+         ++level_iter ) {
+        res = sum_no_wrap( res, level_iter->second );
         if( res >= qty ) {
             return true;
         }
@@ -274,6 +281,15 @@ int visitable<Character>::max_quality( const quality_id &qual ) const
     return std::max( res, max_quality_internal( *this, qual ) );
 }
 
+/** @relates visitable */
+template <>
+int visitable<inventory>::max_quality( const quality_id &qual ) const
+{
+    const auto &index = static_cast<const inventory *>( this )->get_quality_index();
+    const auto iter = index.find( qual );
+    return iter == index.end() ? INT_MIN : iter->second.rbegin()->first;
+}
+
 /** @relates visitable */
 template <>
 int visitable<vehicle_cursor>::max_quality( const quality_id &qual ) const
@@ -580,6 +596,10 @@ std::list<item> visitable<inventory>::remove_items_with( const
             ++stack;
         }
     }
+    if( !res.empty() ) {
+        // The type bins and the quality index may point to or count removed items.
+        inv->unsort();
+    }
     return res;
 }
 
@@ -651,8 +671,11 @@ std::list<item> visitable<map_cursor>::remove_items_with( const
     point offset;
     submap *sub = g->m.get_submap_at( *cur, offset );
 
-    for( auto iter = sub->itm[ offset.x ][ offset.y ].begin();
-         iter != sub->itm[ offset.x ][ offset.y ].end(); ) {
+    cata::colony<item> *const items = sub->itm.find( offset );
+    if( items == nullptr ) {
+        return res;
+    }
+    for( auto iter = items->begin(); iter != items->end(); ) {
         if( filter( *iter ) ) {
             // remove from the active items cache (if it isn't there does nothing)
             sub->active_items.remove( &*iter );
@@ -662,7 +685,8 @@ std::list<item> visitable<map_cursor>::remove_items_with( const
 
             // finally remove the item
             res.push_back( *iter );
-            iter = sub->itm[ offset.x ][ offset.y ].erase( iter );
+            iter = items->erase( iter );
+            sub->emptied_tiles = true;
 
             if( --count == 0 ) {
                 return res;
@@ -139,8 +139,27 @@ weather_type current_weather( const tripoint &location, const time_point &t )
 }
 
 ////// Funnels.
-weather_sum sum_conditions( const time_point &start, const time_point &end,
-                            const tripoint &location )
+static weather_sum &operator+=( weather_sum &lhs, const weather_sum &rhs )
+{
+    lhs.rain_amount += rhs.rain_amount;
+    lhs.acid_amount += rhs.acid_amount;
+    lhs.sunlight += rhs.sunlight;
+    lhs.wind_amount += rhs.wind_amount;
+    return lhs;
+}
+
+static weather_sum operator-( weather_sum lhs, const weather_sum &rhs )
+{
+    lhs.rain_amount -= rhs.rain_amount;
+    lhs.acid_amount -= rhs.acid_amount;
+    lhs.sunlight -= rhs.sunlight;
+    lhs.wind_amount -= rhs.wind_amount;
+    return lhs;
+}
+
+// Samples the weather from start to end, without wind.
+static weather_sum sample_conditions( const time_point &start, const time_point &end,
+                                      const tripoint &location )
 {
     time_duration tick_size = 0_turns;
     weather_sum data;
@@ -157,13 +176,36 @@ weather_sum sum_conditions( const time_point &start, const time_point &end,
 
         weather_type wtype = current_weather( location, t );
         proc_weather_sum( wtype, data, t, tick_size );
-        data.wind_amount += get_local_windpower( g->weather.windspeed, overmap_buffer.ter( location ),
-                            location,
-                            g->weather.winddirection, false ) * to_turns<int>( tick_size );
     }
     return data;
 }
 
+weather_sum sum_conditions( const time_point &start, const time_point &end,
+                            const tripoint &location )
+{
+    if( end <= start ) {
+        return weather_sum();
+    }
+
+    weather_sum data;
+    // Full hours come from the timeline shared by the submap, only the rest is sampled here.
+    const time_point first_hour = start + ( 1_hours - ( start - calendar::turn_zero ) % 1_hours ) %
+                                  1_hours;
+    const time_point last_hour = end - ( end - calendar::turn_zero ) % 1_hours;
+    if( start >= calendar::turn_zero && first_hour < last_hour ) {
+        data = sample_conditions( start, first_hour, location );
+        data += g->weather.get_catchup_weather( location, first_hour, last_hour );
+        data += sample_conditions( last_hour, end, location );
+    } else {
+        data = sample_conditions( start, end, location );
+    }
+
+    // The wind doesn't depend on the time, see get_local_windpower.
+    data.wind_amount = get_local_windpower( g->weather.windspeed, overmap_buffer.ter( location ),
+                                            location, g->weather.winddirection, false ) * to_turns<int>( end - start );
+    return data;
+}
+
 /**
  * Determine what a funnel has filled out of game, using funnelcontainer.bday as a starting point.
  */
@@ -1039,9 +1081,98 @@ int weather_manager::get_temperature( const tripoint &location )
     return temp;
 }
 
+double weather_manager::get_catchup_temperature( const tripoint &location, const time_point &t )
+{
+    const weather_generator &wgen = get_cur_weather_gen();
+    const unsigned seed = g->get_seed();
+    if( ( t - calendar::turn_zero ) % 1_hours != 0_turns ) {
+        return wgen.get_weather_temperature( location, t, seed );
+    }
+
+    const tripoint abs_sm = ms_to_sm_copy( location );
+    hourly_temperature_timeline &timeline = catchup_temperature_cache[abs_sm];
+    // Sample the whole submap at its corner so the result does not depend on which item asked first
+    const tripoint sample_pos = sm_to_ms_copy( abs_sm );
+    if( timeline.temperatures.empty() || t < timeline.start ) {
+        // Extend backwards; anything already sampled is kept
+        std::vector<double> earlier;
+        const time_point old_start = timeline.temperatures.empty() ? t + 1_hours : timeline.start;
+        for( time_point h = t; h < old_start; h += 1_hours ) {
+            earlier.push_back( wgen.get_weather_temperature( sample_pos, h, seed ) );
+        }
+        earlier.insert( earlier.end(), timeline.temperatures.begin(), timeline.temperatures.end() );
+        timeline.temperatures = std::move( earlier );
+        timeline.start = t;
+    }
+    const size_t index = static_cast<size_t>( ( t - timeline.start ) / 1_hours );
+    while( timeline.temperatures.size() <= index ) {
+        const time_point h = timeline.start + 1_hours * static_cast<int>( timeline.temperatures.size() );
+        timeline.temperatures.push_back( wgen.get_weather_temperature( sample_pos, h, seed ) );
+    }
+    return timeline.temperatures[index];
+}
+
+// The weather over the hour starting at @p hour, without wind. Like sample_conditions, the
+// sunlight of hours more than a week ago is only sampled once. The timelines are cleared every
+// turn, so what counts as a week ago doesn't change while they are in use.
+static weather_sum hourly_conditions( const tripoint &location, const time_point &hour )
+{
+    weather_sum data;
+    const weather_type wtype = current_weather( location, hour );
+    if( calendar::turn - hour > 7_days ) {
+        proc_weather_sum( wtype, data, hour, 1_hours );
+        return data;
+    }
+    for( time_point t = hour; t < hour + 1_hours; t += 1_minutes ) {
+        proc_weather_sum( wtype, data, t, 1_minutes );
+    }
+    return data;
+}
+
+weather_sum weather_manager::get_catchup_weather( const tripoint &location,
+        const time_point &start, const time_point &end )
+{
+    const tripoint abs_sm = ms_to_sm_copy( location );
+    hourly_weather_timeline &timeline = catchup_weather_cache[abs_sm];
+    // Sample the whole submap at its corner so the result does not depend on who asked first
+    const tripoint sample_pos = sm_to_ms_copy( abs_sm );
+    if( timeline.totals.empty() || timeline.weather_override != weather_override ) {
+        timeline.start = start;
+        timeline.weather_override = weather_override;
+        timeline.totals.assign( 1, weather_sum() );
+    } else if( start < timeline.start ) {
+        // Extend backwards, keeping anything already sampled
+        std::vector<weather_sum> totals( 1, weather_sum() );
+        for( time_point h = start; h < timeline.start; h += 1_hours ) {
+            weather_sum next = totals.back();
+            next += hourly_conditions( sample_pos, h );
+            totals.push_back( next );
+        }
+        const weather_sum earlier = totals.back();
+        for( size_t i = 1; i < timeline.totals.size(); i++ ) {
+            weather_sum next = earlier;
+            next += timeline.totals[i];
+            totals.push_back( next );
+        }
+        timeline.totals = std::move( totals );
+        timeline.start = start;
+    }
+    const size_t last = static_cast<size_t>( ( end - timeline.start ) / 1_hours );
+    while( timeline.totals.size() <= last ) {
+        const time_point h = timeline.start + 1_hours * static_cast<int>( timeline.totals.size() - 1 );
+        weather_sum next = timeline.totals.back();
+        next += hourly_conditions( sample_pos, h );
+        timeline.totals.push_back( next );
+    }
+    const size_t first = static_cast<size_t>( ( start - timeline.start ) / 1_hours );
+    return timeline.totals[last] - timeline.totals[first];
+}
+
 void weather_manager::clear_temp_cache()
 {
     temperature_cache.clear();
+    catchup_temperature_cache.clear();
+    catchup_weather_cache.clear();
 }
 
 ///@}
@@ -211,6 +211,28 @@ weather_type current_weather( const tripoint &location,
 int incident_sunlight( weather_type wtype,
                        const time_point &t = calendar::turn );
 
+/**
+ * Hourly outdoor temperatures of one submap, starting at @ref start.
+ * Entry i is the weather temperature (in Fahrenheit) at start + i hours.
+ */
+struct hourly_temperature_timeline {
+    time_point start = calendar::turn_zero;
+    std::vector<double> temperatures;
+};
+
+/**
+ * Weather of one submap over consecutive full hours starting at @ref start, as running totals:
+ * entry i is the sum over the first i hours, so entry 0 is empty. The weather is sampled once
+ * per hour, the sunlight once per minute (once per hour for hours more than a week before the
+ * current turn). Wind isn't included.
+ */
+struct hourly_weather_timeline {
+    time_point start = calendar::turn_zero;
+    /** The weather override the totals were sampled with. */
+    weather_type weather_override = WEATHER_NULL;
+    std::vector<weather_sum> totals;
+};
+
 class weather_manager
 {
     public:
@@ -238,6 +260,24 @@ class weather_manager
         std::unordered_map< tripoint, int > temperature_cache;
         // Returns outdoor or indoor temperature of given location (in absolute (@ref map::getabs))
         int get_temperature( const tripoint &location );
+        /**
+         * Outdoor weather temperature (in Fahrenheit, without local modifiers) used when
+         * catching up on item temperature and rot. Full hours are sampled once per absolute
+         * submap and shared by all items there, other times are computed directly.
+         * @param location Absolute position (@ref map::getabs).
+         */
+        double get_catchup_temperature( const tripoint &location, const time_point &t );
+        /** Memoized hourly temperatures, keyed on absolute submap, cleared every turn. */
+        std::unordered_map< tripoint, hourly_temperature_timeline > catchup_temperature_cache;
+        /**
+         * Rain, acid rain and sunlight summed up over the full hours from @p start to @p end,
+         * taken from a timeline shared by everything in the same absolute submap.
+         * @param location Absolute position (@ref map::getabs).
+         */
+        weather_sum get_catchup_weather( const tripoint &location, const time_point &start,
+                                         const time_point &end );
+        /** Memoized hourly weather sums, keyed on absolute submap, cleared every turn. */
+        std::unordered_map< tripoint, hourly_weather_timeline > catchup_weather_cache;
         void clear_temp_cache();
 };
 
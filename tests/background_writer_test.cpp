@@ -0,0 +1,104 @@
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "background_writer.h"
+#include "catch/catch.hpp"
+#include "cata_utility.h"
+#include "filesystem.h"
+#include "game.h"
+
+static std::string read_file( const std::string &path )
+{
+    std::string content = "<missing>";
+    read_from_file_optional( path, [&content]( std::istream & fin ) {
+        std::ostringstream buffer;
+        buffer << fin.rdbuf();
+        content = buffer.str();
+    } );
+    return content;
+}
+
+TEST_CASE( "background_writer_writes_queued_files", "[background_writer]" )
+{
+    const std::string dir = g->get_world_base_save_path();
+    const std::string first = dir + "/background_writer_test_1.txt";
+    const std::string second = dir + "/background_writer_test_2.txt";
+    remove_file( first );
+    remove_file( second );
+
+    background_writer writer;
+    writer.write( first, "old" );
+    writer.write( second, "second" );
+    // Replaces the first job, unless it is already written anyway.
+    writer.write( first, "new" );
+    writer.wait_for( first );
+    CHECK( read_file( first ) == "new" );
+
+    writer.flush();
+    CHECK( writer.pending() == 0 );
+    CHECK( read_file( second ) == "second" );
+
+    writer.remove( second );
+    writer.wait_for( second );
+    CHECK_FALSE( file_exist( second ) );
+
+    remove_file( first );
+}
+
+TEST_CASE( "background_writer_applies_updates_after_queued_writes", "[background_writer]" )
+{
+    const std::string path = g->get_world_base_save_path() + "/background_writer_test_1.txt";
+    remove_file( path );
+
+    background_writer writer;
+    writer.write( path, "0123456789" );
+    file_patch patch;
+    patch.emplace_back( 10, "ab" );
+    patch.emplace_back( 0, "x" );
+    // Depends on the queued write, so it must not replace it.
+    writer.update( path, patch );
+    writer.wait_for( path );
+    CHECK( read_file( path ) == "x123456789ab" );
+
+    remove_file( path );
+}
+
+TEST_CASE( "background_writer_reports_failed_writes", "[background_writer]" )
+{
+    background_writer writer;
+    writer.write( g->get_world_base_save_path() + "/no/such/directory/file.txt", "data" );
+    CHECK_THROWS_AS( writer.flush(), std::runtime_error );
+    // The error is only reported once.
+    CHECK_NOTHROW( writer.flush() );
+}
+
+TEST_CASE( "background_writer_keeps_obsolete_files_of_failed_jobs", "[background_writer]" )
+{
+    const std::string dir = g->get_world_base_save_path();
+    const std::string obsolete = dir + "/background_writer_test_1.txt";
+    const std::string target = dir + "/background_writer_test_2.txt";
+    const std::string missing = dir + "/no/such/directory/file.txt";
+    remove_file( target );
+
+    background_writer writer;
+    writer.write( obsolete, "only copy" );
+    writer.flush();
+
+    // Patching a file that does not exist fails, the file it replaces must stay.
+    file_patch patch;
+    patch.emplace_back( 0, "data" );
+    writer.update( missing, patch, { obsolete } );
+    CHECK_THROWS_AS( writer.flush(), std::runtime_error );
+    CHECK( read_file( obsolete ) == "only copy" );
+    CHECK( writer.take_failure( missing ) );
+    CHECK_FALSE( writer.take_failure( missing ) );
+
+    writer.write( target, "new copy", { obsolete } );
+    writer.flush();
+    CHECK( read_file( target ) == "new copy" );
+    CHECK_FALSE( file_exist( obsolete ) );
+    CHECK_FALSE( writer.take_failure( target ) );
+
+    remove_file( target );
+}
@@ -511,3 +511,70 @@ TEST_CASE( "crafting_interruption", "[crafting]" )
         }
     }
 }
+
+TEST_CASE( "inventory_quality_index", "[crafting]" )
+{
+    const quality_id hammering( "HAMMER" );
+    const quality_id boiling( "BOIL" );
+    inventory inv;
+    CHECK_FALSE( inv.has_quality( hammering ) );
+    CHECK( inv.max_quality( hammering ) == INT_MIN );
+
+    const item hammer( "hammer" );
+    const int level = hammer.get_quality( hammering );
+    REQUIRE( level > 0 );
+    inv.add_item( hammer );
+    inv.add_item( hammer );
+    CHECK( inv.has_quality( hammering, level, 2 ) );
+    CHECK_FALSE( inv.has_quality( hammering, level, 3 ) );
+    CHECK_FALSE( inv.has_quality( hammering, level + 1 ) );
+    CHECK( inv.max_quality( hammering ) == level );
+
+    // Pots only boil while they are empty.
+    item full_pot( "pot" );
+    REQUIRE( full_pot.get_quality( boiling ) > 0 );
+    full_pot.put_in( item( "water_clean", calendar::turn, 1 ) );
+    inv.add_item( full_pot );
+    CHECK_FALSE( inv.has_quality( boiling ) );
+
+    inv.clear();
+    CHECK_FALSE( inv.has_quality( hammering ) );
+    inv.add_item( item( "pot" ) );
+    CHECK( inv.has_quality( boiling ) );
+    CHECK( inv.max_quality( boiling ) == item( "pot" ).get_quality( boiling ) );
+
+    // Removing items directly, as consuming tools does, updates the index as well.
+    inv.remove_items_with( []( const item & e ) {
+        return e.typeId() == "pot";
+    } );
+    CHECK_FALSE( inv.has_quality( boiling ) );
+}
+
+TEST_CASE( "batch_recipe_availability_matches_single_checks", "[crafting]" )
+{
+    std::vector<item> tools;
+    tools.emplace_back( "hotplate", -1, 20 );
+    item plastic_bottle( "bottle_plastic" );
+    plastic_bottle.contents.emplace_back( "water", -1, 2 );
+    tools.push_back( plastic_bottle );
+    tools.emplace_back( "pot" );
+    tools.emplace_back( "hammer" );
+    prep_craft( recipe_id( "water_clean" ), tools, true );
+
+    std::vector<const recipe *> recipes;
+    for( const auto &e : recipe_dict ) {
+        if( !e.second.obsolete ) {
+            recipes.push_back( &e.second );
+        }
+    }
+    const std::vector<bool> batch = g->u.can_start_crafts( recipes );
+    REQUIRE( batch.size() == recipes.size() );
+    int available = 0;
+    for( size_t i = 0; i < recipes.size(); ++i ) {
+        INFO( recipes[i]->ident().str() );
+        CHECK( batch[i] == g->u.can_start_craft( recipes[i] ) );
+        available += batch[i] ? 1 : 0;
+    }
+    CHECK( available > 0 );
+    CHECK( g->u.can_start_crafts( { &recipe_id( "water_clean" ).obj() } ) == std::vector<bool> { true } );
+}
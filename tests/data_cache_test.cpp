@@ -0,0 +1,38 @@
+#include <string>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "data_cache.h"
+#include "filesystem.h"
+#include "omdata.h"
+#include "path_info.h"
+
+TEST_CASE( "data_cache_round_trip", "[data_cache]" )
+{
+    const data_cache::cached_type *type = data_cache::find_cached_type( "overmap_land_use_code" );
+    REQUIRE( type != nullptr );
+    CHECK( data_cache::find_cached_type( "material" ) == nullptr );
+    const std::vector<overmap_land_use_code> original = overmap_land_use_codes::get_all();
+    REQUIRE_FALSE( original.empty() );
+
+    data_cache::save( *type, "key" );
+    // A cache written for other files or another version is not used.
+    CHECK_FALSE( data_cache::load( *type, "other key" ) );
+    CHECK( overmap_land_use_codes::get_all().empty() );
+
+    REQUIRE( data_cache::load( *type, "key" ) );
+    const std::vector<overmap_land_use_code> &loaded = overmap_land_use_codes::get_all();
+    REQUIRE( loaded.size() == original.size() );
+    for( size_t i = 0; i < original.size(); i++ ) {
+        INFO( original[i].id.str() );
+        CHECK( loaded[i].id == original[i].id );
+        CHECK( loaded[i].land_use_code == original[i].land_use_code );
+        CHECK( loaded[i].name == original[i].name );
+        CHECK( loaded[i].detailed_definition == original[i].detailed_definition );
+        CHECK( loaded[i].symbol == original[i].symbol );
+        CHECK( loaded[i].color == original[i].color );
+    }
+    CHECK( land_use_code_forest.is_valid() );
+
+    remove_file( FILENAMES["datacachedir"] + "overmap_land_use_code.bin" );
+}
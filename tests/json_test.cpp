@@ -2,6 +2,7 @@
 
 #include <list>
 #include <sstream>
+#include <string>
 
 #include "bodypart.h"
 #include "catch/catch.hpp"
@@ -26,6 +27,13 @@ void test_serialization( const T &val, const std::string &s )
         CHECK( jsin.read( read_val ) );
         CHECK( val == read_val );
     }
+    {
+        INFO( "test_deserialization_from_buffer" );
+        JsonIn jsin( s );
+        T read_val;
+        CHECK( jsin.read( read_val ) );
+        CHECK( val == read_val );
+    }
 }
 
 TEST_CASE( "serialize_colony", "[json]" )
@@ -69,3 +77,97 @@ TEST_CASE( "serialize_set", "[json]" )
     std::set<body_part> enum_set = { bp_foot_l };
     test_serialization( enum_set, string_format( R"([%d])", static_cast<int>( bp_foot_l ) ) );
 }
+
+// Reads everything in the document, in a form that shows differences in the values read.
+static std::string dump_json( JsonIn &jsin )
+{
+    std::ostringstream out;
+    if( jsin.test_object() ) {
+        JsonObject jo = jsin.get_object();
+        out << '{';
+        for( const std::string &name : jo.get_member_names() ) {
+            out << name << ':';
+            JsonIn *member = jo.get_raw( name );
+            out << dump_json( *member ) << ',';
+        }
+        out << '}';
+    } else if( jsin.test_array() ) {
+        out << '[';
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            out << dump_json( jsin ) << ',';
+        }
+        out << ']';
+    } else if( jsin.test_string() ) {
+        out << '<' << jsin.get_string() << '>';
+    } else if( jsin.test_bool() ) {
+        out << ( jsin.get_bool() ? "yes" : "no" );
+    } else if( jsin.test_null() ) {
+        jsin.skip_null();
+        out << "nothing";
+    } else {
+        out << jsin.get_float();
+    }
+    return out.str();
+}
+
+static std::string parse_error( JsonIn &jsin )
+{
+    try {
+        dump_json( jsin );
+    } catch( const JsonError &err ) {
+        return err.what();
+    }
+    return "no error";
+}
+
+TEST_CASE( "json_from_buffer_matches_json_from_stream", "[json]" )
+{
+    const std::string doc = R"({
+  "id": "thing", "//": "comment",
+  "name": "esc\"aped \\ \u00e9 \n",
+  "list": [ 1, -2.5, 3e2, true, false, null, "", { "a": [ ] } ],
+  "nested": { "deeper": { "deepest": "end" } }
+}
+)";
+    std::istringstream is( doc );
+    JsonIn from_stream( is );
+    JsonIn from_buffer( doc );
+    const std::string expected = dump_json( from_stream );
+    CHECK( dump_json( from_buffer ) == expected );
+    CHECK( expected.find( "<esc\"aped \\ \xc3\xa9 \n>" ) != std::string::npos );
+
+    for( const std::string &broken : {
+             std::string( R"({ "a": 1 "b": 2 })" ), std::string( R"([ 1, 2, ])" ),
+             std::string( R"({ "a": "unterminated )" ), std::string( "[ tru ]" ),
+             std::string( R"({ "a": 1, "a": 2 })" )
+         } ) {
+        CAPTURE( broken );
+        std::istringstream broken_is( broken );
+        JsonIn broken_stream( broken_is );
+        JsonIn broken_buffer( broken );
+        const std::string error = parse_error( broken_stream );
+        CHECK( error != "no error" );
+        CHECK( parse_error( broken_buffer ) == error );
+    }
+}
+
+TEST_CASE( "json_object_from_index", "[json]" )
+{
+    const std::string doc = R"([ { "a": 1, "b": [ 2, 3 ], "c": { "d": "e" } }, { "f": "g" } ])";
+    JsonIn indexing( doc );
+    indexing.start_array();
+    std::vector<JsonObject::member_index> objects;
+    while( !indexing.end_array() ) {
+        objects.push_back( JsonObject::index_members( indexing ) );
+    }
+    REQUIRE( objects.size() == 2 );
+
+    JsonIn jsin( doc );
+    JsonObject first( jsin, std::move( objects[0] ) );
+    CHECK( first.get_int( "a" ) == 1 );
+    CHECK( first.get_array( "b" ).size() == 2 );
+    CHECK( first.get_object( "c" ).get_string( "d" ) == "e" );
+    JsonObject second( jsin, std::move( objects[1] ) );
+    CHECK( second.get_string( "f" ) == "g" );
+}
@@ -90,6 +90,81 @@ TEST_CASE( "map_memory_survives_save_lod", "[map_memory]" )
     CHECK( memory.get_symbol( p3 ) == memory2.get_symbol( p3 ) );
 }
 
+TEST_CASE( "map_memory_forgets_whole_chunks", "[map_memory]" )
+{
+    map_memory memory;
+    // Two locations in the same submap, one in the next submap.
+    memory.memorize_tile( 3, { 0, 0, 0 }, "t_dirt", 1, 2 );
+    memory.memorize_tile( 3, { 5, 5, 0 }, "t_grass", 0, 0 );
+    memory.memorize_symbol( 3, { SEEX, 0, 0 }, 'x' );
+    CHECK( memory.size() == 3 );
+    CHECK( memory.get_tile( { 5, 5, 0 } ).tile == "t_grass" );
+
+    // Exceeding the limit forgets the least recently written submap as a whole.
+    memory.memorize_symbol( 3, { SEEX, 1, 0 }, 'y' );
+    CHECK( memory.size() == 2 );
+    CHECK( memory.get_tile( { 0, 0, 0 } ).tile.empty() );
+    CHECK( memory.get_tile( { 5, 5, 0 } ).tile.empty() );
+    CHECK( memory.get_symbol( { SEEX, 0, 0 } ) == 'x' );
+    CHECK( memory.get_symbol( { SEEX, 1, 0 } ) == 'y' );
+
+    memory.clear_memorized_tile( { SEEX, 0, 0 } );
+    CHECK( memory.size() == 1 );
+    CHECK( memory.get_symbol( { SEEX, 0, 0 } ) == 0 );
+}
+
+TEST_CASE( "map_memory_chunks_survive_save_load", "[map_memory]" )
+{
+    map_memory memory;
+    const tripoint negative( -1, -SEEY - 1, -2 );
+    memory.memorize_tile( 100, p1, "t_dirt", 1, 2 );
+    memory.memorize_tile( 100, negative, "t_wall", 3, 1 );
+    memory.memorize_tile( 100, p2, "t_dirt", 0, 3 );
+    memory.memorize_symbol( 100, p3, 'z' );
+
+    std::ostringstream jsout_s;
+    JsonOut jsout( jsout_s );
+    memory.store( jsout );
+    INFO( "Json was: " << jsout_s.str() );
+    std::istringstream jsin_s( jsout_s.str() );
+    JsonIn jsin( jsin_s );
+    map_memory memory2;
+    memory2.load( jsin );
+
+    CHECK( memory2.size() == memory.size() );
+    for( const tripoint &p : { p1, p2, p3, negative } ) {
+        const memorized_terrain_tile expected = memory.get_tile( p );
+        const memorized_terrain_tile loaded = memory2.get_tile( p );
+        CHECK( loaded.tile == expected.tile );
+        CHECK( loaded.subtile == expected.subtile );
+        CHECK( loaded.rotation == expected.rotation );
+        CHECK( memory2.get_symbol( p ) == memory.get_symbol( p ) );
+    }
+    CHECK( memory2.get_tile( negative ).tile == "t_wall" );
+
+    // Copies keep their own order of least recently used chunks.
+    map_memory memory3 = memory2;
+    memory2.memorize_symbol( 4, tripoint_zero, 'a' );
+    memory3.memorize_symbol( 4, tripoint_zero, 'a' );
+    CHECK( memory2.get_tile( p1 ).tile.empty() );
+    CHECK( memory3.get_tile( p1 ).tile.empty() );
+    CHECK( memory3.get_tile( p2 ).tile == "t_dirt" );
+}
+
+TEST_CASE( "map_memory_loads_previous_format", "[map_memory]" )
+{
+    std::istringstream jsin_s( R"([[[0,0,1,"t_dirt",1,2],[0,0,2,"t_wall",0,0]],[[0,0,3,120]]])" );
+    JsonIn jsin( jsin_s );
+    map_memory memory;
+    memory.load( jsin );
+    CHECK( memory.size() == 3 );
+    CHECK( memory.get_tile( p1 ).tile == "t_dirt" );
+    CHECK( memory.get_tile( p1 ).subtile == 1 );
+    CHECK( memory.get_tile( p1 ).rotation == 2 );
+    CHECK( memory.get_tile( p2 ).tile == "t_wall" );
+    CHECK( memory.get_symbol( p3 ) == 120 );
+}
+
 #include <chrono>
 
 TEST_CASE( "lru_cache_perf", "[.]" )
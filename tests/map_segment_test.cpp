@@ -0,0 +1,100 @@
+#include <istream>
+#include <map>
+#include <string>
+
+#include "background_writer.h"
+#include "cata_utility.h"
+#include "catch/catch.hpp"
+#include "filesystem.h"
+#include "game.h"
+#include "map_segment.h"
+#include "optional.h"
+#include "point.h"
+
+static std::string read_quad( const map_segment_file &segment, const tripoint &om_addr )
+{
+    return segment.read( om_addr ).value_or( "<missing>" );
+}
+
+TEST_CASE( "map_segment_file_stores_quads", "[map_segment]" )
+{
+    const std::string path = g->get_world_base_save_path() + "/map_segment_test.seg";
+    remove_file( path );
+
+    map_segment_file segment( path );
+    CHECK_FALSE( segment.load_index() );
+    CHECK_FALSE( segment.read( tripoint_zero ) );
+
+    const tripoint first( -1, 2, -3 );
+    const tripoint second( 5, 6, 0 );
+    std::map<tripoint, std::string> quads;
+    quads[first] = "[{\"version\":1}]";
+    quads[second] = std::string( "binary\0data", 11 );
+    segment.write( quads );
+    CHECK( segment.has( first ) );
+    CHECK( read_quad( segment, second ) == quads[second] );
+
+    // A fresh reader only has the file.
+    map_segment_file reloaded( path );
+    REQUIRE( reloaded.load_index() );
+    CHECK( reloaded.read_all() == quads );
+
+    // Writing again replaces the given quads and keeps the others.
+    std::map<tripoint, std::string> update;
+    update[second] = "[]";
+    update[tripoint_above] = "[{}]";
+    reloaded.write( update );
+    map_segment_file updated( path );
+    REQUIRE( updated.load_index() );
+    CHECK( read_quad( updated, first ) == quads[first] );
+    CHECK( read_quad( updated, second ) == std::string( "[]" ) );
+    CHECK( read_quad( updated, tripoint_above ) == std::string( "[{}]" ) );
+    CHECK_FALSE( updated.has( tripoint_zero ) );
+
+    // Until the header is switched over, the file keeps its old content.
+    std::map<tripoint, std::string> lost;
+    lost[first] = "[1]";
+    const file_patch patch = updated.serialize( lost );
+    REQUIRE( patch.size() == 2 );
+    CHECK( patch.front().first != 0 );
+    patch_file( path, file_patch( patch.begin(), patch.begin() + 1 ) );
+    map_segment_file interrupted( path );
+    REQUIRE( interrupted.load_index() );
+    CHECK( read_quad( interrupted, first ) == quads[first] );
+    patch_file( path, patch );
+    REQUIRE( interrupted.load_index() );
+    CHECK( read_quad( interrupted, first ) == std::string( "[1]" ) );
+    CHECK( read_quad( interrupted, tripoint_above ) == std::string( "[{}]" ) );
+
+    remove_file( path );
+}
+
+TEST_CASE( "map_segment_file_drops_stale_data", "[map_segment]" )
+{
+    const std::string path = g->get_world_base_save_path() + "/map_segment_test.seg";
+    remove_file( path );
+
+    map_segment_file segment( path );
+    std::map<tripoint, std::string> quads;
+    quads[tripoint_zero] = std::string( 1000, 'a' );
+    segment.write( quads );
+    for( int i = 0; i < 200; i++ ) {
+        std::map<tripoint, std::string> update;
+        update[tripoint_east] = std::string( 1000, static_cast<char>( 'b' + i % 20 ) );
+        segment.write( update );
+    }
+    // Each save appends, but the file is rewritten before it consists mostly of stale data.
+    std::streamoff size = 0;
+    read_from_file( path, [&size]( std::istream & fin ) {
+        fin.seekg( 0, std::ios::end );
+        size = fin.tellg();
+    } );
+    CHECK( size < 100 * 1000 );
+
+    map_segment_file reloaded( path );
+    REQUIRE( reloaded.load_index() );
+    CHECK( read_quad( reloaded, tripoint_zero ) == quads[tripoint_zero] );
+    CHECK( read_quad( reloaded, tripoint_east ) == std::string( 1000, 'b' + 199 % 20 ) );
+
+    remove_file( path );
+}
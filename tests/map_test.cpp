@@ -1,10 +1,17 @@
 #include <memory>
 
 #include "avatar.h"
+#include "calendar.h"
 #include "catch/catch.hpp"
+#include "field.h"
 #include "game.h"
+#include "iexamine.h"
+#include "item.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "mapbuffer.h"
+#include "mapdata.h"
+#include "submap.h"
 #include "enums.h"
 #include "game_constants.h"
 #include "type_id.h"
@@ -78,3 +85,129 @@ TEST_CASE( "tinymap_bounds_checking" )
         }
     }
 }
+
+TEST_CASE( "map_cache_rebuilds_changed_submaps" )
+{
+    clear_map();
+    const tripoint origin( 60, 60, 0 );
+    const tripoint wall = origin + tripoint( 2, 0, 0 );
+    const tripoint behind = origin + tripoint( 4, 0, 0 );
+    g->u.setpos( origin );
+    g->m.build_map_cache( 0, true );
+    const float open_transparency = g->m.light_transparency( wall );
+    REQUIRE( g->m.get_cache_ref( 0 ).seen_cache[behind.x][behind.y] > 0.0f );
+
+    g->m.ter_set( wall, t_wall );
+    g->m.build_map_cache( 0, true );
+    CHECK( g->m.light_transparency( wall ) == LIGHT_TRANSPARENCY_SOLID );
+    CHECK( g->m.get_cache_ref( 0 ).seen_cache[behind.x][behind.y] == 0.0f );
+
+    g->m.ter_set( wall, t_grass );
+    g->m.build_map_cache( 0, true );
+    CHECK( g->m.light_transparency( wall ) == open_transparency );
+    CHECK( g->m.get_cache_ref( 0 ).seen_cache[behind.x][behind.y] > 0.0f );
+}
+
+TEST_CASE( "map_sees_caches_lines_until_the_transparency_changes" )
+{
+    clear_map();
+    const tripoint origin( 60, 60, 0 );
+    const tripoint wall = origin + tripoint( 2, 0, 0 );
+    const tripoint behind = origin + tripoint( 4, 0, 0 );
+    g->u.setpos( origin );
+    g->m.build_map_cache( 0, true );
+    g->m.reset_sight_line_cache_stats();
+
+    CHECK( g->m.sees( origin, behind, 10 ) );
+    // Same line in the other direction and with another range.
+    CHECK( g->m.sees( behind, origin, 5 ) );
+    CHECK_FALSE( g->m.sees( origin, behind, 3 ) );
+    CHECK( g->m.get_sight_line_cache_stats().hits == 1 );
+    CHECK( g->m.get_sight_line_cache_stats().misses == 1 );
+
+    g->m.ter_set( wall, t_wall );
+    g->m.build_map_cache( 0, true );
+    CHECK_FALSE( g->m.sees( origin, behind, 10 ) );
+    CHECK( g->m.get_sight_line_cache_stats().invalidations == 1 );
+
+    g->m.ter_set( wall, t_grass );
+    g->m.build_map_cache( 0, true );
+}
+
+TEST_CASE( "map_sees_forgets_lines_changed_out_of_the_players_view" )
+{
+    clear_map_and_put_player_underground();
+    const tripoint origin( 60, 60, 0 );
+    const tripoint wall = origin + tripoint( 2, 0, 0 );
+    const tripoint behind = origin + tripoint( 4, 0, 0 );
+    g->m.build_map_cache( 0, true );
+    REQUIRE( g->m.sees( origin, behind, 10 ) );
+
+    // The player can't see the wall being built, monsters must still notice it.
+    g->m.ter_set( wall, t_wall );
+    g->m.build_map_cache( 0, true );
+    CHECK_FALSE( g->m.sees( origin, behind, 10 ) );
+
+    g->m.ter_set( wall, t_grass );
+    g->m.build_map_cache( 0, true );
+}
+
+TEST_CASE( "map_only_keeps_storage_for_tiles_with_items_or_fields" )
+{
+    clear_map();
+    const tripoint p( 60, 60, 0 );
+    const point l( p.x % SEEX, p.y % SEEY );
+    submap *const sm = MAPBUFFER.lookup_submap( g->m.get_abs_sub() +
+                       tripoint( p.x / SEEX, p.y / SEEY, 0 ) );
+    REQUIRE( sm != nullptr );
+    const field_type_id fire( "fd_fire" );
+    // Earlier tests may have left items here.
+    g->m.i_clear( p );
+    g->m.release_empty_tiles();
+
+    // Only checking does not allocate.
+    const map &const_map = g->m;
+    CHECK_FALSE( g->m.has_items( p ) );
+    CHECK( const_map.field_at( p ).field_count() == 0 );
+    CHECK( sm->itm.find( l ) == nullptr );
+    CHECK( sm->fld.find( l ) == nullptr );
+
+    // Storage handed out for changes is released again if nothing was added.
+    CHECK( g->m.i_at( p ).empty() );
+    CHECK( g->m.field_at( p ).field_count() == 0 );
+    CHECK( sm->itm.find( l ) != nullptr );
+    g->m.release_empty_tiles();
+    CHECK( sm->itm.find( l ) == nullptr );
+    CHECK( sm->fld.find( l ) == nullptr );
+
+    map_stack stack = g->m.i_at( p );
+    stack.insert( item( "rock" ) );
+    CHECK( stack.size() == 1 );
+    CHECK( g->m.i_at( p ).size() == 1 );
+    g->m.add_field( p, fire, 1 );
+    CHECK( sm->fld.find( l ) != nullptr );
+
+    // The storage stays until the end of the turn, as it may still be referenced.
+    g->m.i_clear( p );
+    g->m.remove_field( p, fire );
+    CHECK( sm->itm.find( l ) != nullptr );
+    g->m.release_empty_tiles();
+    CHECK( sm->itm.find( l ) == nullptr );
+    CHECK( sm->fld.find( l ) == nullptr );
+}
+
+TEST_CASE( "pouring_into_an_empty_keg" )
+{
+    clear_map();
+    const tripoint p( 60, 60, 0 );
+    g->m.i_clear( p );
+    g->m.release_empty_tiles();
+    g->m.furn_set( p, furn_str_id( "f_standing_tank" ) );
+
+    item water( "water", calendar::turn, 10 );
+    REQUIRE( iexamine::pour_into_keg( p, water ) );
+    CHECK( water.charges == 0 );
+    REQUIRE( g->m.i_at( p ).size() == 1 );
+    CHECK( g->m.i_at( p ).only_item().typeId() == "water" );
+    CHECK( g->m.i_at( p ).only_item().charges == 10 );
+}
@@ -5,11 +5,13 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <set>
 #include <memory>
 #include <utility>
 
 #include "avatar.h"
 #include "catch/catch.hpp"
+#include "creature_tracker.h"
 #include "game.h"
 #include "map.h"
 #include "map_helpers.h"
@@ -334,3 +336,91 @@ TEST_CASE( "monster_speed_trig", "[speed]" )
     trigdist = true;
     monster_check();
 }
+
+static std::set<const monster *> monsters_in_radius_brute_force( const tripoint &center,
+        int radius )
+{
+    std::set<const monster *> result;
+    for( const monster &critter : g->all_monsters() ) {
+        if( rl_dist( center, critter.pos() ) <= radius ) {
+            result.insert( &critter );
+        }
+    }
+    return result;
+}
+
+TEST_CASE( "creature_tracker_radius_query", "[monster]" )
+{
+    clear_map_and_put_player_underground();
+    const std::vector<tripoint> spawns = {
+        { 5, 5, 0 }, { 11, 11, 0 }, { 12, 12, 0 }, { 30, 40, 0 }, { 60, 60, 0 },
+        { 61, 60, 0 }, { 70, 65, 0 }, { 100, 20, 0 }, { 65, 64, 0 }
+    };
+    for( const tripoint &p : spawns ) {
+        spawn_test_monster( "mon_zombie", p );
+    }
+    monster &mover = spawn_test_monster( "mon_zombie", tripoint( 62, 62, 0 ) );
+
+    const auto check_queries = []() {
+        for( const tripoint &center : {
+                 tripoint( 60, 60, 0 ), tripoint( 0, 0, 0 ), tripoint( 11, 12, 0 ), tripoint( 120, 5, 0 )
+             } ) {
+            for( int radius : { -1, 0, 1, 5, 12, 13, 40, 200 } ) {
+                CAPTURE( center );
+                CAPTURE( radius );
+                const std::vector<monster *> found =
+                    g->critter_tracker->find_in_radius( center, radius );
+                const std::set<const monster *> found_set( found.begin(), found.end() );
+                CHECK( found.size() == found_set.size() );
+                CHECK( found_set == monsters_in_radius_brute_force( center, radius ) );
+            }
+        }
+    };
+    check_queries();
+
+    // Filtered queries return exactly the accepted part of the unfiltered one.
+    const tripoint center( 60, 60, 0 );
+    const auto east_of_center = [&center]( const monster & critter ) {
+        return critter.posx() > center.x;
+    };
+    std::set<const monster *> expected;
+    for( const monster *critter : g->critter_tracker->find_in_radius( center, 12 ) ) {
+        if( east_of_center( *critter ) ) {
+            expected.insert( critter );
+        }
+    }
+    const std::vector<monster *> filtered =
+        g->critter_tracker->find_in_radius( center, 12, east_of_center );
+    CHECK( std::set<const monster *>( filtered.begin(), filtered.end() ) == expected );
+    CHECK( expected.size() == 4 );
+
+    // Moving across a submap boundary must move the monster to another bucket.
+    mover.setpos( tripoint( 75, 80, 0 ) );
+    check_queries();
+    CHECK( g->critter_tracker->find_in_radius( tripoint( 62, 62, 0 ), 0 ).empty() );
+    REQUIRE( g->critter_tracker->find_in_radius( tripoint( 75, 80, 0 ), 0 ).size() == 1 );
+
+    mover.die( nullptr );
+    g->cleanup_dead();
+    check_queries();
+    CHECK( g->critter_tracker->find_in_radius( tripoint( 75, 80, 0 ), 0 ).empty() );
+}
+
+TEST_CASE( "creature_tracker_sight_memo_is_cleared_on_removal", "[monster]" )
+{
+    clear_map_and_put_player_underground();
+    monster &observer = spawn_test_monster( "mon_zombie", tripoint( 60, 60, 0 ) );
+    monster &target = spawn_test_monster( "mon_zombie", tripoint( 62, 60, 0 ) );
+    monster &bystander = spawn_test_monster( "mon_zombie", tripoint( 30, 30, 0 ) );
+    REQUIRE( g->critter_tracker->sees_this_turn( observer, target ) );
+
+    // The result is kept for the rest of the turn...
+    g->m.ter_set( tripoint( 61, 60, 0 ), ter_id( "t_wall" ) );
+    g->m.build_map_cache( 0, true );
+    REQUIRE_FALSE( observer.sees( target ) );
+    CHECK( g->critter_tracker->sees_this_turn( observer, target ) );
+
+    // ...unless a monster is removed, its address may be reused by another one.
+    g->remove_zombie( bystander );
+    CHECK_FALSE( g->critter_tracker->sees_this_turn( observer, target ) );
+}
@@ -1,9 +1,15 @@
+#include <algorithm>
+#include <climits>
 #include <memory>
+#include <set>
+#include <tuple>
 #include <string>
 #include <vector>
 
 #include "catch/catch.hpp"
+#include "line.h"
 #include "map.h"
+#include "map_iterator.h"
 #include "overmap.h"
 #include "overmapbuffer.h"
 #include "calendar.h"
@@ -106,3 +112,86 @@ TEST_CASE( "default_overmap_generation_has_non_mandatory_specials_at_origin" )
     CHECK( found_optional == true );
 }
 
+
+static std::set<tripoint> all_ter_locations( const overmap &om, const std::string &type,
+        ot_match_type match_type )
+{
+    std::set<tripoint> result;
+    for( const std::vector<tripoint> *locations : om.find_ter_locations( type, match_type ) ) {
+        result.insert( locations->begin(), locations->end() );
+    }
+    return result;
+}
+
+TEST_CASE( "overmap_terrain_location_index_follows_ter_set" )
+{
+    std::unique_ptr<overmap> test_overmap = std::make_unique<overmap>( point_zero );
+    const oter_id cabin( "cabin_north" );
+    const oter_id field( "field" );
+    // Searching for a terrain that is not there yet still indexes it.
+    CHECK( all_ter_locations( *test_overmap, "cabin", ot_match_type::type ).empty() );
+    test_overmap->ter_set( { 10, 10, 0 }, cabin );
+
+    CHECK( all_ter_locations( *test_overmap, "cabin", ot_match_type::type ) ==
+           std::set<tripoint> { { 10, 10, 0 } } );
+
+    // The index exists now and has to be updated by further changes.
+    test_overmap->ter_set( { 20, 30, -1 }, cabin );
+    test_overmap->ter_set( { 10, 10, 0 }, field );
+    CHECK( all_ter_locations( *test_overmap, "cabin", ot_match_type::type ) ==
+           std::set<tripoint> { { 20, 30, -1 } } );
+    CHECK( all_ter_locations( *test_overmap, "cabin_north", ot_match_type::exact ) ==
+           std::set<tripoint> { { 20, 30, -1 } } );
+    CHECK( all_ter_locations( *test_overmap, "field", ot_match_type::type ).count( { 10, 10, 0 } ) ==
+           1 );
+}
+
+TEST_CASE( "overmap_find_closest_and_find_all_match_exhaustive_search" )
+{
+    if( !overmap_buffer.has( point_zero ) ) {
+        overmap_special_batch test_specials = overmap_specials::get_default_batch( point_zero );
+        overmap_buffer.create_custom_overmap( point_zero, test_specials );
+    }
+    const tripoint origin( OMAPX / 2, OMAPY / 2, 0 );
+    const int radius = 30;
+
+    for( const std::string &type : {
+             "forest", "field", "road", "cabin"
+         } ) {
+        CAPTURE( type );
+        omt_find_params params;
+        params.type = type;
+        params.match_type = ot_match_type::prefix;
+        params.search_range = radius;
+        params.existing_only = true;
+
+        tripoint expected_closest = overmap::invalid_tripoint;
+        std::tuple<int, int, tripoint> best( INT_MAX, INT_MAX, overmap::invalid_tripoint );
+        std::set<tripoint> expected_all;
+        for( const tripoint &p : tripoint_range( origin - tripoint( radius, radius, OVERMAP_DEPTH ),
+                origin + tripoint( radius, radius, OVERMAP_HEIGHT ) ) ) {
+            if( !overmap_buffer.check_ot_existing( type, ot_match_type::prefix, p ) ) {
+                continue;
+            }
+            if( p.z == origin.z ) {
+                expected_all.insert( p );
+            }
+            const std::tuple<int, int, tripoint> key( square_dist( origin.xy(), p.xy() ),
+                    std::abs( p.z - origin.z ), p );
+            if( p != origin && key < best ) {
+                best = key;
+                expected_closest = p;
+            }
+        }
+        if( overmap_buffer.check_ot_existing( type, ot_match_type::prefix, origin ) ) {
+            expected_closest = origin;
+        }
+
+        CHECK( overmap_buffer.find_closest( origin, params ) == expected_closest );
+        const std::vector<tripoint> found = overmap_buffer.find_all( origin, params );
+        CHECK( std::set<tripoint>( found.begin(), found.end() ) == expected_all );
+        CHECK( std::is_sorted( found.begin(), found.end(), [&]( const tripoint & l, const tripoint & r ) {
+            return square_dist( origin, l ) < square_dist( origin, r );
+        } ) );
+    }
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include "calendar.h"
+#include "catch/catch.hpp"
+#include "game.h"
+#include "game_constants.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "type_id.h"
+
+static const pathfinding_settings walking( 0, 100, 1000, 0, false, false, true, false );
+
+// A wall across the map at x = 50 with a single gap at y = 60.
+static void build_wall_with_gap()
+{
+    clear_map();
+    for( int y = 0; y < MAPSIZE_Y; y++ ) {
+        if( y != 60 ) {
+            g->m.ter_set( tripoint( 50, y, 0 ), ter_id( "t_wall" ) );
+        }
+    }
+}
+
+static void check_route( const std::vector<tripoint> &route, const tripoint &from,
+                         const tripoint &to )
+{
+    REQUIRE_FALSE( route.empty() );
+    CHECK( route.back() == to );
+    tripoint last = from;
+    for( const tripoint &p : route ) {
+        INFO( "step from " << last.to_string() << " to " << p.to_string() );
+        CHECK( square_dist( last, p ) == 1 );
+        CHECK( g->m.passable( p ) );
+        last = p;
+    }
+}
+
+TEST_CASE( "route_finds_the_gap_in_a_wall", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    const tripoint from( 40, 55, 0 );
+    const tripoint to( 60, 55, 0 );
+
+    const std::vector<tripoint> route = g->m.route( from, to, walking );
+    check_route( route, from, to );
+    CHECK( std::find( route.begin(), route.end(), tripoint( 50, 60, 0 ) ) != route.end() );
+
+    // The workspace is reused, earlier searches must not leak into later ones.
+    check_route( g->m.route( to, from, walking ), to, from );
+    CHECK( g->m.route( from, to, walking ) == route );
+
+    // Closing the gap leaves no way through.
+    const std::set<tripoint> closed = { tripoint( 50, 60, 0 ) };
+    CHECK( g->m.route( from, to, walking, closed ).empty() );
+    check_route( g->m.route( from, to, walking ), from, to );
+}
+
+// Cost as used by the pathfinders, on flat ground only.
+static int flat_route_cost( const std::vector<tripoint> &route, const tripoint &from )
+{
+    int cost = 0;
+    tripoint last = from;
+    for( const tripoint &p : route ) {
+        cost += 2 + ( last.x != p.x && last.y != p.y ? 1 : 0 );
+        last = p;
+    }
+    return cost;
+}
+
+TEST_CASE( "shared_routes_are_as_good_as_single_routes", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    const tripoint target( 60, 55, 0 );
+    const std::vector<tripoint> starts = {
+        tripoint( 40, 55, 0 ), tripoint( 45, 40, 0 ), tripoint( 38, 70, 0 ), tripoint( 65, 50, 0 )
+    };
+    // Small groups search on their own, enough requests get the field built.
+    for( int i = 0; i < 16; i++ ) {
+        g->m.route_shared( starts.front(), target, walking );
+    }
+    for( const tripoint &from : starts ) {
+        const std::vector<tripoint> single = g->m.route( from, target, walking );
+        const std::vector<tripoint> shared = g->m.route_shared( from, target, walking );
+        check_route( shared, from, target );
+        CHECK( flat_route_cost( shared, from ) <= flat_route_cost( single, from ) );
+    }
+}
+
+TEST_CASE( "hierarchical_route_crosses_the_map", "[pathfinding]" )
+{
+    build_wall_with_gap();
+    const tripoint from( 10, 55, 0 );
+    const tripoint to( 120, 55, 0 );
+    // Targets beyond max_dist are left alone, like in map::route.
+    CHECK( g->m.route( from, to, walking ).empty() );
+    CHECK( g->m.route_hierarchical( from, to, walking ).empty() );
+
+    pathfinding_settings far_walk = walking;
+    far_walk.max_dist = 200;
+    const std::vector<tripoint> route = g->m.route_hierarchical( from, to, far_walk );
+    check_route( route, from, to );
+    CHECK( std::find( route.begin(), route.end(), tripoint( 50, 60, 0 ) ) != route.end() );
+
+    // The whole route is held to the length limit, not each leg.
+    pathfinding_settings short_walk = far_walk;
+    short_walk.max_length = 150;
+    CHECK( g->m.route_hierarchical( from, to, short_walk ).empty() );
+
+    // A free straight line is taken as it is.
+    const tripoint through_gap_from( 10, 60, 0 );
+    const tripoint through_gap_to( 120, 60, 0 );
+    CHECK( g->m.route_hierarchical( through_gap_from, through_gap_to, far_walk ) ==
+           line_to( through_gap_from, through_gap_to ) );
+
+    // Changing the map rebuilds the portals: with the gap closed there is no way through.
+    g->m.ter_set( tripoint( 50, 60, 0 ), ter_id( "t_wall" ) );
+    CHECK( g->m.route_hierarchical( from, to, far_walk ).empty() );
+
+    // Only the changed submap and its neighbours are rebuilt, opening another gap elsewhere
+    // links the rest of the graph again.
+    g->m.ter_set( tripoint( 50, 20, 0 ), ter_id( "t_floor" ) );
+    const std::vector<tripoint> detour = g->m.route_hierarchical( from, to, far_walk );
+    check_route( detour, from, to );
+    CHECK( std::find( detour.begin(), detour.end(), tripoint( 50, 20, 0 ) ) != detour.end() );
+}
+
+TEST_CASE( "route_performance_in_a_crowd", "[.]" )
+{
+    build_wall_with_gap();
+    const tripoint target( 70, 60, 0 );
+    // Like the monsters with the longest reach, the crowd is within max_dist of its target.
+    const pathfinding_settings chasing( 0, 50, 250, 0, false, false, true, false );
+    constexpr int turns = 100;
+    for( const int crowd_size : { 1, 2, 3, 5, 10, 30, 100 } ) {
+        std::vector<tripoint> crowd;
+        for( int i = 0; i < crowd_size; i++ ) {
+            crowd.emplace_back( 25 + i % 10 * 2, 35 + i / 10 * 5, 0 );
+        }
+        size_t steps = 0;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for( int turn = 0; turn < turns; turn++ ) {
+            for( const tripoint &p : crowd ) {
+                steps += g->m.route( p, target, chasing ).size();
+            }
+        }
+        const auto start_shared = std::chrono::high_resolution_clock::now();
+        for( int turn = 0; turn < turns; turn++ ) {
+            calendar::turn += 1_turns;
+            for( const tripoint &p : crowd ) {
+                steps += g->m.route_shared( p, target, chasing ).size();
+            }
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        CHECK( steps > 0 );
+        const long long route_us = std::chrono::duration_cast<std::chrono::microseconds>
+                                   ( start_shared - start ).count();
+        const long long shared_us = std::chrono::duration_cast<std::chrono::microseconds>
+                                    ( end - start_shared ).count();
+        printf( "%d creatures routing to one target: route %lld us per turn, route_shared %lld us per turn\n",
+                crowd_size, route_us / turns, shared_us / turns );
+    }
+}
@@ -9,6 +9,8 @@
 #include "game.h"
 #include "flat_set.h"
 #include "point.h"
+#include "weather.h"
+#include "weather_gen.h"
 
 
 static bool is_nearly( float value, float expected )
@@ -51,3 +53,26 @@ TEST_CASE( "Rate of rotting" )
         CHECK( is_nearly( to_turns<int>( test_item.get_rot() ), to_turns<int>( 20_minutes ) ) );
     }
 }
+
+TEST_CASE( "Shared catch-up temperature timeline" )
+{
+    const weather_generator &wgen = g->weather.get_cur_weather_gen();
+    const time_point full_hour = calendar::turn_zero + 30_days;
+    const tripoint corner( 120, 240, 0 );
+    const tripoint inside = corner + tripoint( 5, 7, 0 );
+
+    g->weather.clear_temp_cache();
+
+    // Full hours are sampled once per submap, at its corner
+    CHECK( g->weather.get_catchup_temperature( inside, full_hour ) ==
+           wgen.get_weather_temperature( corner, full_hour, g->get_seed() ) );
+    CHECK( g->weather.get_catchup_temperature( corner, full_hour - 5_hours ) ==
+           wgen.get_weather_temperature( corner, full_hour - 5_hours, g->get_seed() ) );
+    CHECK( g->weather.get_catchup_temperature( corner, full_hour + 3_hours ) ==
+           wgen.get_weather_temperature( corner, full_hour + 3_hours, g->get_seed() ) );
+
+    // Other times are not shared
+    const time_point between = full_hour + 20_minutes;
+    CHECK( g->weather.get_catchup_temperature( inside, between ) ==
+           wgen.get_weather_temperature( inside, between, g->get_seed() ) );
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "catch/catch.hpp"
+#include "game_constants.h"
+#include "point.h"
+#include "rng.h"
+#include "scent_map.h"
+
+template<typename T>
+using scent_array = scent_map::scent_array<T>;
+
+// The diffusion as it was implemented before scent_map::diffuse, branching on the flags.
+static void reference_diffuse( scent_array<int> &grscent, const scent_array<bool> &blocks_scent,
+                               const scent_array<bool> &reduces_scent, const point &min, const point &max )
+{
+    std::unique_ptr<scent_array<int>> sum_3_scent_y_ptr = std::make_unique<scent_array<int>>();
+    std::unique_ptr<scent_array<int>> squares_used_y_ptr = std::make_unique<scent_array<int>>();
+    scent_array<int> &sum_3_scent_y = *sum_3_scent_y_ptr;
+    scent_array<int> &squares_used_y = *squares_used_y_ptr;
+    const int diffusivity = 100;
+
+    for( int x = min.x - 1; x <= max.x + 1; ++x ) {
+        for( int y = min.y; y <= max.y; ++y ) {
+            sum_3_scent_y[y][x] = 0;
+            squares_used_y[y][x] = 0;
+            for( int i = y - 1; i <= y + 1; ++i ) {
+                if( !blocks_scent[x][i] ) {
+                    if( reduces_scent[x][i] ) {
+                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
+                        squares_used_y[y][x] += 2;
+                    } else {
+                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
+                        squares_used_y[y][x] += 10;
+                    }
+                }
+            }
+        }
+    }
+
+    for( int x = min.x; x <= max.x; ++x ) {
+        for( int y = min.y; y <= max.y; ++y ) {
+            auto &scent_here = grscent[x][y];
+            if( !blocks_scent[x][y] ) {
+                const int squares_used = squares_used_y[y][x - 1]
+                                         + squares_used_y[y][x]
+                                         + squares_used_y[y][x + 1];
+
+                int this_diffusivity;
+                if( !reduces_scent[x][y] ) {
+                    this_diffusivity = diffusivity;
+                } else {
+                    this_diffusivity = diffusivity / 5;
+                }
+                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+                scent_here =
+                    ( temp_scent
+                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
+                                             + sum_3_scent_y[y][x]
+                                             + sum_3_scent_y[y][x + 1] )
+                    ) / ( 1000 * 10 );
+            } else {
+                scent_here = 0;
+            }
+        }
+    }
+}
+
+struct scent_test_data {
+    scent_array<int> scents;
+    scent_array<bool> blocks;
+    scent_array<bool> reduces;
+    scent_array<int> weights;
+
+    scent_test_data() {
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                scents[x][y] = one_in( 3 ) ? rng( 0, 10000 ) : 0;
+                blocks[x][y] = one_in( 8 );
+                reduces[x][y] = !blocks[x][y] && one_in( 6 );
+                weights[x][y] = blocks[x][y] ? 0 : reduces[x][y] ? 2 : 10;
+            }
+        }
+    }
+};
+
+static const point diffuse_min( 20, 20 );
+static const point diffuse_max( 100, 100 );
+
+TEST_CASE( "scent_diffusion_matches_reference", "[scent]" )
+{
+    std::unique_ptr<scent_test_data> data = std::make_unique<scent_test_data>();
+    std::unique_ptr<scent_array<int>> expected = std::make_unique<scent_array<int>>( data->scents );
+
+    for( int step = 0; step < 10; ++step ) {
+        reference_diffuse( *expected, data->blocks, data->reduces, diffuse_min, diffuse_max );
+        scent_map::diffuse( data->scents, data->weights, diffuse_min, diffuse_max );
+        INFO( "step " << step );
+        REQUIRE( data->scents == *expected );
+    }
+}
+
+TEST_CASE( "scent_diffusion_performance", "[.]" )
+{
+    constexpr int steps = 10000;
+    std::unique_ptr<scent_test_data> data = std::make_unique<scent_test_data>();
+    std::unique_ptr<scent_array<int>> reference = std::make_unique<scent_array<int>>( data->scents );
+
+    const auto start_reference = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < steps; ++i ) {
+        reference_diffuse( *reference, data->blocks, data->reduces, diffuse_min, diffuse_max );
+    }
+    const auto start_diffuse = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < steps; ++i ) {
+        scent_map::diffuse( data->scents, data->weights, diffuse_min, diffuse_max );
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    CHECK( data->scents == *reference );
+    const long long reference_us = std::chrono::duration_cast<std::chrono::microseconds>
+                                   ( start_diffuse - start_reference ).count();
+    const long long diffuse_us = std::chrono::duration_cast<std::chrono::microseconds>
+                                 ( end - start_diffuse ).count();
+    printf( "%d diffusion steps: reference %lld us, scent_map::diffuse %lld us\n",
+            steps, reference_us, diffuse_us );
+}
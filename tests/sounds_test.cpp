@@ -0,0 +1,29 @@
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "point.h"
+#include "sounds.h"
+
+TEST_CASE( "sound_clusters_are_binned_by_submap", "[sounds]" )
+{
+    sounds::reset_sounds();
+    // Two sounds in the same submap, the louder one pulls the centroid towards it.
+    sounds::sound( tripoint( 13, 13, 0 ), 30, sounds::sound_t::combat, "bang" );
+    sounds::sound( tripoint( 23, 13, 0 ), 10, sounds::sound_t::combat, "bang" );
+    // Same x/y, but another z-level.
+    sounds::sound( tripoint( 13, 13, -1 ), 10, sounds::sound_t::combat, "bang" );
+    // Adjacent submap.
+    sounds::sound( tripoint( 24, 13, 0 ), 10, sounds::sound_t::combat, "bang" );
+
+    const std::vector<tripoint> clusters = sounds::get_monster_sounds().second;
+    REQUIRE( clusters.size() == 3 );
+    // Clusters appear in the order of the first sound that fell into them.
+    CHECK( clusters[0] == tripoint( 15, 13, 0 ) );
+    CHECK( clusters[1] == tripoint( 13, 13, -1 ) );
+    CHECK( clusters[2] == tripoint( 24, 13, 0 ) );
+
+    // Clustering the same sounds again gives the same result.
+    CHECK( sounds::get_monster_sounds().second == clusters );
+    sounds::reset_sounds();
+    CHECK( sounds::get_monster_sounds().second.empty() );
+}
@@ -1,7 +1,10 @@
 #include "catch/catch.hpp"
 #include "submap.h"
+#include "colony.h"
+#include "field.h"
 #include "game_constants.h"
 #include "int_id.h"
+#include "item.h"
 #include "point.h"
 #include "type_id.h"
 
@@ -89,3 +92,43 @@ TEST_CASE( "submap rotation", "[submap]" )
         }
     }
 }
+
+TEST_CASE( "submap_stores_items_and_fields_sparsely", "[submap]" )
+{
+    constexpr auto corner = point{ SEEX - 1, 0 };
+    constexpr auto center = point{ SEEX / 2, SEEY / 2 };
+    const field_type_id fire( "fd_fire" );
+
+    submap sm;
+    CHECK( sm.itm.size() == 0 );
+    CHECK( sm.fld.size() == 0 );
+    CHECK( sm.itm.peek( corner ).empty() );
+    CHECK( sm.itm.size() == 0 );
+
+    sm.itm.get( corner ).insert( item( "rock" ) );
+    sm.itm.get( point_zero ).insert( item( "rock" ) );
+    sm.itm.get( point_zero ).insert( item( "rock" ) );
+    sm.fld.get( center ).add_field( fire );
+    CHECK( sm.itm.size() == 2 );
+    CHECK( sm.itm.peek( point_zero ).size() == 2 );
+    CHECK( sm.itm.peek( corner ).size() == 1 );
+    CHECK( sm.itm.find( center ) == nullptr );
+    CHECK( sm.fld.peek( center ).find_field( fire ) != nullptr );
+
+    // Rotating by one turn swaps through a single tile, by two turns swaps tiles directly.
+    sm.rotate( 1 );
+    CHECK( sm.itm.peek( point_zero ).empty() );
+    CHECK( sm.itm.peek( corner ).size() == 2 );
+    CHECK( sm.itm.peek( point{ SEEX - 1, SEEY - 1 } ).size() == 1 );
+    sm.rotate( 2 );
+    CHECK( sm.itm.peek( point{ 0, SEEY - 1 } ).size() == 2 );
+    CHECK( sm.itm.peek( point_zero ).size() == 1 );
+    CHECK( sm.itm.size() == 2 );
+    CHECK( sm.fld.size() == 1 );
+
+    sm.itm.get( point_zero ).clear();
+    sm.release_empty_tiles();
+    CHECK( sm.itm.size() == 1 );
+    CHECK( sm.itm.peek( point{ 0, SEEY - 1 } ).size() == 2 );
+    CHECK( sm.fld.size() == 1 );
+}
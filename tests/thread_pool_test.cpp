@@ -0,0 +1,62 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "catch/catch.hpp"
+#include "thread_pool.h"
+
+TEST_CASE( "thread_pool_runs_every_job_once", "[thread_pool]" )
+{
+    thread_pool pool( 3 );
+    CHECK( pool.size() == 4 );
+
+    for( int jobs : { 0, 1, 7, 100 } ) {
+        std::vector<std::atomic<int>> runs( jobs );
+        for( std::atomic<int> &r : runs ) {
+            r = 0;
+        }
+        pool.run( jobs, [&]( const int i ) {
+            ++runs[i];
+        } );
+        for( int i = 0; i < jobs; ++i ) {
+            INFO( "job " << i << " of " << jobs );
+            CHECK( runs[i] == 1 );
+        }
+    }
+}
+
+TEST_CASE( "thread_pool_without_workers", "[thread_pool]" )
+{
+    thread_pool pool( 0 );
+    std::vector<int> order;
+    pool.run( 5, [&]( const int i ) {
+        order.push_back( i );
+    } );
+    CHECK( order == std::vector<int>( { 0, 1, 2, 3, 4 } ) );
+}
+
+TEST_CASE( "thread_pool_rethrows_after_the_batch", "[thread_pool]" )
+{
+    thread_pool pool( 3 );
+    std::vector<std::atomic<int>> runs( 50 );
+    for( std::atomic<int> &r : runs ) {
+        r = 0;
+    }
+    CHECK_THROWS_AS( pool.run( 50, [&]( const int i ) {
+        ++runs[i];
+        if( i % 10 == 3 ) {
+            throw std::runtime_error( "job failed" );
+        }
+    } ), std::runtime_error );
+    // Every job still ran, nothing of the batch is left behind.
+    for( int i = 0; i < 50; ++i ) {
+        INFO( "job " << i );
+        CHECK( runs[i] == 1 );
+    }
+    // The pool is usable afterwards.
+    int total = 0;
+    pool.run( 1, [&]( int ) {
+        ++total;
+    } );
+    CHECK( total == 1 );
+}
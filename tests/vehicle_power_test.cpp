@@ -1,3 +1,4 @@
+#include <cstdlib>
 #include <memory>
 #include <vector>
 
@@ -88,3 +89,156 @@ TEST_CASE( "vehicle_power" )
         CHECK( veh_ptr->fuel_left( fuel_type_battery ) == 0 );
     }
 }
+
+static void connect_by_cable( vehicle &source, vehicle &target )
+{
+    const vpart_id cable( "jumper_cable" );
+    vehicle_part source_part( cable, point_zero, item( "jumper_cable" ) );
+    source_part.target.first = g->m.getabs( target.global_pos3() );
+    source_part.target.second = source_part.target.first;
+    source.install_part( point_zero, source_part );
+    vehicle_part target_part( cable, point_zero, item( "jumper_cable" ) );
+    target_part.target.first = g->m.getabs( source.global_pos3() );
+    target_part.target.second = target_part.target.first;
+    target.install_part( point_zero, target_part );
+}
+
+static void remove_cable_to( vehicle &veh, const vehicle &target )
+{
+    for( const int p : veh.loose_parts ) {
+        if( veh.parts[p].target.second == g->m.getabs( target.global_pos3() ) ) {
+            veh.remove_part( p );
+            break;
+        }
+    }
+    veh.part_removal_cleanup();
+}
+
+TEST_CASE( "vehicle_power_grid" )
+{
+    for( const wrapped_vehicle &veh : g->m.get_vehicles() ) {
+        g->m.destroy_vehicle( veh.v );
+    }
+    g->refresh_all();
+    REQUIRE( g->m.get_vehicles().empty() );
+
+    vehicle *first = g->m.add_vehicle( vproto_id( "reactor_test" ), tripoint( 10, 10, 0 ), 0, 0, 0 );
+    vehicle *second = g->m.add_vehicle( vproto_id( "reactor_test" ), tripoint( 14, 10, 0 ), 0, 0, 0 );
+    vehicle *third = g->m.add_vehicle( vproto_id( "reactor_test" ), tripoint( 18, 10, 0 ), 0, 0, 0 );
+    REQUIRE( first != nullptr );
+    REQUIRE( second != nullptr );
+    REQUIRE( third != nullptr );
+    for( vehicle *veh : { first, second, third } ) {
+        veh->discharge_battery( veh->fuel_left( fuel_type_battery ), false );
+        REQUIRE( veh->fuel_left( fuel_type_battery ) == 0 );
+    }
+    const int capacity = 1000000 - first->charge_battery( 1000000, false );
+    REQUIRE( capacity > 0 );
+    first->discharge_battery( capacity, false );
+
+    // A chain of vehicles, first - second - third.
+    connect_by_cable( *first, *second );
+    connect_by_cable( *second, *third );
+    first->charge_battery( capacity * 3 );
+    CHECK( first->fuel_left( fuel_type_battery ) == capacity );
+    CHECK( second->fuel_left( fuel_type_battery ) == capacity );
+    const int third_charge = third->fuel_left( fuel_type_battery );
+    // Less than the rest, some is lost in the cables.
+    CHECK( third_charge > 0 );
+    CHECK( third_charge < capacity );
+    CHECK( first->fuel_left( fuel_type_battery, true ) == capacity * 2 + third_charge );
+    CHECK( third->fuel_left( fuel_type_battery, true ) == capacity * 2 + third_charge );
+
+    // Unplugging the third vehicle takes it out of the grid of the others.
+    remove_cable_to( *second, *third );
+    remove_cable_to( *third, *second );
+    CHECK( first->fuel_left( fuel_type_battery, true ) == capacity * 2 );
+    CHECK( third->fuel_left( fuel_type_battery, true ) == third_charge );
+
+    // So does destroying the second one, with no cable left behind.
+    g->m.destroy_vehicle( second );
+    CHECK( first->fuel_left( fuel_type_battery, true ) == capacity );
+    CHECK( first->discharge_battery( capacity * 2 ) == capacity );
+
+    g->m.destroy_vehicle( first );
+    g->m.destroy_vehicle( third );
+}
+
+TEST_CASE( "vehicle_batteries_are_levelled" )
+{
+    for( const wrapped_vehicle &veh : g->m.get_vehicles() ) {
+        g->m.destroy_vehicle( veh.v );
+    }
+    g->refresh_all();
+
+    vehicle *veh = g->m.add_vehicle( vproto_id( "hispeed_split_test" ), tripoint( 30, 30, 0 ), 0, 0,
+                                     0 );
+    REQUIRE( veh != nullptr );
+    std::vector<vehicle_part *> batteries;
+    for( vehicle_part &p : veh->parts ) {
+        if( p.is_battery() ) {
+            batteries.push_back( &p );
+        }
+    }
+    REQUIRE( batteries.size() == 2 );
+    veh->discharge_battery( veh->fuel_left( fuel_type_battery ), false );
+    REQUIRE( veh->fuel_left( fuel_type_battery ) == 0 );
+    const auto percent = []( const vehicle_part * p ) {
+        return p->ammo_remaining() * 100 / p->ammo_capacity();
+    };
+
+    // Charge goes to the emptiest battery first, discharge takes from the fullest.
+    const int capacity = batteries[0]->ammo_capacity() + batteries[1]->ammo_capacity();
+    CHECK( veh->charge_battery( capacity / 3, false ) == 0 );
+    CHECK( std::abs( percent( batteries[0] ) - percent( batteries[1] ) ) <= 1 );
+    CHECK( veh->discharge_battery( capacity / 6, false ) == 0 );
+    CHECK( std::abs( percent( batteries[0] ) - percent( batteries[1] ) ) <= 1 );
+    CHECK( veh->fuel_left( fuel_type_battery ) == capacity / 3 - capacity / 6 );
+
+    g->m.destroy_vehicle( veh );
+}
+
+TEST_CASE( "weather_catch_up_is_shared_by_whole_hours" )
+{
+    const tripoint location = g->m.getabs( tripoint( 10, 10, 0 ) );
+    const time_point hour = calendar::turn_zero + calendar::season_length() + 2_days;
+    const time_point start = hour - 20_minutes;
+    const time_point middle = hour + 30_hours;
+    const time_point end = middle + 3_hours + 10_minutes;
+    g->weather.weather_override = WEATHER_NULL;
+    g->weather.clear_temp_cache();
+
+    // The later part first, so the timeline has to be extended backwards.
+    const weather_sum second = sum_conditions( middle, end, location );
+    const weather_sum first = sum_conditions( start, middle, location );
+    const weather_sum whole = sum_conditions( start, end, location );
+    CHECK( whole.rain_amount == first.rain_amount + second.rain_amount );
+    CHECK( whole.acid_amount == first.acid_amount + second.acid_amount );
+    CHECK( whole.sunlight == Approx( first.sunlight + second.sunlight ) );
+    CHECK( whole.sunlight > 0 );
+
+    // Sampling a new timeline gives the same as the extended one.
+    g->weather.clear_temp_cache();
+    const weather_sum again = sum_conditions( start, end, location );
+    CHECK( again.rain_amount == whole.rain_amount );
+    CHECK( again.sunlight == Approx( whole.sunlight ) );
+
+    g->weather.weather_override = WEATHER_SUNNY;
+    const weather_sum sunny = sum_conditions( start, end, location );
+    CHECK( sunny.rain_amount == 0 );
+    CHECK( sunny.acid_amount == 0 );
+
+    // Like a direct catch-up, hours more than a week ago only sample the sunlight once.
+    const time_point old_turn = calendar::turn;
+    calendar::turn = end + 8_days;
+    g->weather.clear_temp_cache();
+    const weather_sum old_sunny = sum_conditions( hour, middle, location );
+    int expected_sunlight = 0;
+    for( time_point h = hour; h < middle; h += 1_hours ) {
+        expected_sunlight += incident_sunlight( WEATHER_SUNNY, h ) * to_turns<int>( 1_hours );
+    }
+    CHECK( old_sunny.sunlight == Approx( expected_sunlight ) );
+    calendar::turn = old_turn;
+    g->weather.clear_temp_cache();
+    g->weather.weather_override = WEATHER_NULL;
+}
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "avatar.h"
@@ -7,6 +9,8 @@
 #include "map.h"
 #include "map_helpers.h"
 #include "vehicle.h"
+#include "vpart_position.h"
+#include "vpart_range.h"
 #include "enums.h"
 #include "type_id.h"
 #include "point.h"
@@ -69,3 +73,52 @@ TEST_CASE( "add_item_to_broken_vehicle_part" )
     const item itm2 = item( "jeans" );
     REQUIRE( !veh_ptr->add_item( *cargo_part, itm2 ) );
 }
+
+static void check_part_lookups( const vehicle &veh )
+{
+    for( const vpart_reference &vp : veh.get_all_parts() ) {
+        std::vector<int> cached = veh.parts_at_relative( vp.mount(), true );
+        std::vector<int> scanned = veh.parts_at_relative( vp.mount(), false );
+        std::sort( cached.begin(), cached.end() );
+        CHECK( cached == scanned );
+
+        const optional_vpart_position here = g->m.veh_at( vp.pos() );
+        REQUIRE( here );
+        CHECK( &here->vehicle() == &veh );
+        CHECK( here->mount() == vp.mount() );
+    }
+}
+
+TEST_CASE( "vehicle_part_lookup_grids" )
+{
+    clear_map();
+    const tripoint vehicle_origin( 60, 60, 0 );
+    vehicle *veh_ptr = g->m.add_vehicle( vproto_id( "car" ), vehicle_origin, 0, 0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    check_part_lookups( *veh_ptr );
+    CHECK( veh_ptr->parts_at_relative( point( 100, 100 ), true ).empty() );
+    CHECK( veh_ptr->parts_at_relative( point( -100, -100 ), true ).empty() );
+
+    std::set<tripoint> old_points;
+    for( const vpart_reference &vp : veh_ptr->get_all_parts() ) {
+        old_points.insert( vp.pos() );
+    }
+    // Where the parts end up, as vehicle movement works it out before displacing.
+    veh_ptr->precalc_mounts( 1, veh_ptr->face.dir(), veh_ptr->pivot_point() );
+    tripoint pos = veh_ptr->global_pos3();
+    veh_ptr = g->m.displace_vehicle( pos, tripoint( 20, 0, 0 ) );
+    REQUIRE( veh_ptr != nullptr );
+    check_part_lookups( *veh_ptr );
+    for( const tripoint &p : old_points ) {
+        CHECK_FALSE( g->m.veh_at( p ) );
+    }
+
+    // Removing all parts at a mount point leaves a hole in the grid.
+    const point mount = veh_ptr->parts.back().mount;
+    for( const int p : veh_ptr->parts_at_relative( mount, true ) ) {
+        veh_ptr->remove_part( p );
+    }
+    veh_ptr->part_removal_cleanup();
+    CHECK( veh_ptr->parts_at_relative( mount, true ).empty() );
+    check_part_lookups( *veh_ptr );
+}
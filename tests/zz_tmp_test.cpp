@@ -0,0 +1,36 @@
+#include <chrono>
+#include <cstdio>
+#include "calendar.h"
+#include "catch/catch.hpp"
+#include "game.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "pathfinding.h"
+
+TEST_CASE( "zz_tmp", "[.]" )
+{
+    clear_map();
+    for( int y = 0; y < MAPSIZE_Y; y++ ) {
+        if( y != 60 ) {
+            g->m.ter_set( tripoint( 50, y, 0 ), ter_id( "t_wall" ) );
+        }
+    }
+    const tripoint target( 70, 60, 0 );
+    const pathfinding_settings chasing( 0, 10, 50, 0, false, false, true, false );
+    for( int x = 20; x < 30; x++ ) {
+        const tripoint p( x, 35, 0 );
+        printf( "route from %d: %zu, ter %s, passable %d\n", x, g->m.route( p, target, chasing ).size(),
+                g->m.tername( p ).c_str(), g->m.passable( p ) ? 1 : 0 );
+    }
+    for( int turn = 0; turn < 3; turn++ ) {
+        calendar::turn += 1_turns;
+        for( int i = 0; i < 4; i++ ) {
+            const tripoint p( 62 + i, 55 + i, 0 );
+            const auto s = std::chrono::high_resolution_clock::now();
+            size_t n = g->m.route_shared( p, target, chasing ).size();
+            const auto e = std::chrono::high_resolution_clock::now();
+            printf( "turn %d creature %d: %zu steps, %lld us\n", turn, i, n,
+                    static_cast<long long>( std::chrono::duration_cast<std::chrono::microseconds>( e - s ).count() ) );
+        }
+    }
+}